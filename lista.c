@@ -78,6 +78,22 @@ void imprimir_posiciones(ListaInt* cabeza) {
     }
 }
 
+/**
+ * @brief Escribe todas las posiciones de la lista en un buffer.
+ *
+ * Usa el mismo formato que imprimir_posiciones().
+ *
+ * @param cabeza Puntero al primer nodo de la lista.
+ * @param salida Buffer de destino.
+ */
+void escribir_posiciones(ListaInt* cabeza, Salida* salida) {
+    ListaInt* actual = cabeza;
+    while (actual != NULL) {
+        salida_printf(salida, " %d", actual->pos);
+        actual = actual->siguiente;
+    }
+}
+
 /**
  * @brief Libera toda la memoria asociada a la lista enlazada.
  *
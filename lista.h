@@ -1,6 +1,8 @@
 #ifndef LISTA_H
 #define LISTA_H
 
+#include "salida.h"
+
 /**
  * @brief Nodo de la lista que guarda una posición.
  */
@@ -37,6 +39,13 @@ int contar_posiciones(ListaInt* cabeza);
  */
 void imprimir_posiciones(ListaInt* cabeza);
 
+/**
+ * @brief Escribe todas las posiciones en un buffer de salida.
+ * @param cabeza Puntero a la lista.
+ * @param salida Buffer de destino.
+ */
+void escribir_posiciones(ListaInt* cabeza, Salida* salida);
+
 /**
  * @brief Libera toda la memoria usada por la lista.
  * @param cabeza Puntero a la lista.
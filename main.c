@@ -1,14 +1,10 @@
 #include "trie.h"
+#include "trie_compacto.h"
+#include "servidor.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-/// Tamano del gen cargado
-int GEN_SIZE = 0;
-
-/// Nodo raiz del trie
-Nodo* TRIE_ROOT = NULL;
-
 /**
  * @brief Funcion principal del programa BioSearch.
  *
@@ -17,20 +13,37 @@ Nodo* TRIE_ROOT = NULL;
  * de ADN, buscar genes, mostrar estadisticas y finalizar el programa.
  *
  * Comandos soportados:
- * - start m
+ * - start m [compact]
  * - read archivo.txt
  * - search GEN
  * - max
  * - min
  * - all
+ * - compact
  * - help
  * - exit
  *
+ * Tambien puede ejecutarse como servidor con
+ * "./bio serve ruta_socket m archivo.txt [compact]", que carga el indice una
+ * sola vez y responde consultas search, max, min y all por un socket Unix.
+ *
+ * @param argc Cantidad de argumentos.
+ * @param argv Argumentos de la linea de comandos.
  * @return 0 al finalizar la ejecucion.
  */
-int main(void) {
+int main(int argc, char* argv[]) {
     char linea[256];
     char comando[10], arg1[100];
+    Indice indice = {NULL, NULL, 0, 0};
+
+    if (argc > 1) {
+        int compactar = argc == 6 && strcmp(argv[5], "compact") == 0;
+        if (strcmp(argv[1], "serve") != 0 || (argc != 5 && !compactar)) {
+            printf("%sUso: ./bio serve ruta_socket m archivo.txt [compact]%s\n", AMARILLO, RESET);
+            return 1;
+        }
+        return bio_serve(argv[2], atoi(argv[3]), argv[4], compactar) == 0 ? 0 : 1;
+    }
     
     printf("%sBienvenido a BioSearch!%s\n", VERDE, RESET);
     printf("%sPara obtener ayuda, escriba 'help'%s\n", AMARILLO, RESET);
@@ -38,7 +51,7 @@ int main(void) {
         printf("%s>bio %s", MORADO, RESET);
 
         if (fgets(linea, sizeof(linea), stdin) == NULL) {
-            bio_exit();
+            bio_exit(&indice);
             break;
         }
 
@@ -46,31 +59,41 @@ int main(void) {
         int num_args = sscanf(linea, "%s %s", comando, arg1);
 
         if (strcmp(comando, "start") == 0) {
-            if (num_args == 2) bio_start(atoi(arg1));
-            else printf("%sUso: bio start m%s\n", AMARILLO, RESET);
+            char modo[10];
+            if (num_args == 2 && sscanf(linea, "%*s %*s %9s", modo) == 1) {
+                if (strcmp(modo, "compact") == 0) bio_start_compacto(&indice, atoi(arg1));
+                else printf("%sUso: bio start m [compact]%s\n", AMARILLO, RESET);
+            } else if (num_args == 2) {
+                bio_start(&indice, atoi(arg1));
+            } else {
+                printf("%sUso: bio start m [compact]%s\n", AMARILLO, RESET);
+            }
 
         } else if (strcmp(comando, "help") == 0) {
             help();
 
         } else if (strcmp(comando, "read") == 0) {
-            if (num_args == 2) bio_read(arg1);
+            if (num_args == 2) bio_read(&indice, arg1);
             else printf("%sUso: bio read adn.txt%s\n", AMARILLO, RESET);
 
         } else if (strcmp(comando, "search") == 0) {
-            if (num_args == 2) bio_search(arg1);
+            if (num_args == 2) bio_search(&indice, arg1);
             else printf("%sUso: bio search GEN%s\n", AMARILLO, RESET);
 
         } else if (strcmp(comando, "max") == 0 && num_args == 1) {
-            bio_max();
+            bio_max(&indice);
 
         } else if (strcmp(comando, "min") == 0 && num_args == 1) {
-            bio_min();
+            bio_min(&indice);
 
         } else if (strcmp(comando, "all") == 0 && num_args == 1) {
-            bio_all();
+            bio_all(&indice);
+
+        } else if (strcmp(comando, "compact") == 0 && num_args == 1) {
+            bio_compact(&indice);
 
         } else if (strcmp(comando, "exit") == 0 && num_args == 1) {
-            bio_exit();
+            bio_exit(&indice);
             break;
 
         } else {
@@ -0,0 +1,393 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "recorrido_paralelo.h"
+#include "trie.h"
+#include "trie_compacto.h"
+#include "salida.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+
+/**
+ * @brief Subarbol que recorre un hilo como una unidad de trabajo.
+ */
+typedef struct Tarea {
+    Nodo* nodo;            /**< Raiz del subarbol en el trie de punteros */
+    long nodo_compacto;    /**< Raiz del subarbol en el trie compacto */
+    char* gen;             /**< Buffer del gen, con el prefijo ya escrito */
+    int extremum;          /**< Frecuencia extrema encontrada en el subarbol */
+    Salida salida;         /**< Genes escritos por el subarbol */
+    int terminada;         /**< 1 cuando el hilo termino el subarbol */
+} Tarea;
+
+/**
+ * @brief Estado de un recorrido enviado al pool de hilos.
+ *
+ * Los campos siguiente, limite, terminadas y terminada de cada tarea se
+ * protegen con el mutex del pool.
+ */
+typedef struct Recorrido {
+    const Indice* indice;     /**< Indice que se recorre */
+    Tarea* tareas;            /**< Subarboles en orden lexicografico */
+    long num_tareas;          /**< Cantidad de subarboles */
+    long siguiente;           /**< Primer subarbol que nadie ha tomado */
+    long limite;              /**< Se pueden tomar subarboles con indice menor a este */
+    long terminadas;          /**< Subarboles ya recorridos */
+    int nivel_corte;          /**< Nivel de las raices de los subarboles */
+    int imprimir;             /**< 1 = escribir genes, 0 = buscar extremos */
+    int mode;                 /**< 1 = max, 0 = min (solo para extremos) */
+    int target_freq;          /**< Frecuencia a imprimir, o 0 para todos */
+    pthread_cond_t avance;    /**< Se avisa cada vez que termina una tarea */
+    struct Recorrido* siguiente_pendiente;  /**< Siguiente recorrido con tareas sin tomar */
+} Recorrido;
+
+/// Protege la cola de recorridos pendientes y el avance de sus tareas
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Se avisa cuando llega un recorrido nuevo a la cola
+static pthread_cond_t pool_trabajo = PTHREAD_COND_INITIALIZER;
+
+/// Recorridos que todavia tienen subarboles sin tomar, en orden de llegada
+static Recorrido* pool_pendientes = NULL;
+
+/// Asegura que el pool se cree una sola vez
+static pthread_once_t pool_inicio = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Obtiene la cantidad de hilos a usar.
+ *
+ * @return Procesadores en linea, entre 1 y PARALELO_MAX_HILOS.
+ */
+int paralelo_num_hilos(void) {
+    long hilos = sysconf(_SC_NPROCESSORS_ONLN);
+    if (hilos < 1) return 1;
+    if (hilos > PARALELO_MAX_HILOS) return PARALELO_MAX_HILOS;
+    return (int)hilos;
+}
+
+/**
+ * @brief Agrega como tareas los subarboles que cuelgan del nivel de corte.
+ *
+ * Los subarboles se agregan en orden lexicografico. En el trie compacto
+ * solo se agregan los subarboles que existen.
+ *
+ * @param r Recorrido donde se agregan las tareas.
+ * @param nodo Nodo actual del trie de punteros.
+ * @param nodo_compacto Nodo actual del trie compacto.
+ * @param prefijo Bases desde la raiz hasta el nodo actual.
+ * @param nivel Nivel actual.
+ * @return 0 si se generaron correctamente, -1 si falla la asignacion.
+ */
+int generar_tareas(Recorrido* r, Nodo* nodo, long nodo_compacto, char* prefijo, int nivel) {
+    const TrieCompacto* tc = r->indice->compacto;
+    if (tc == NULL && nodo == NULL) return 0;
+
+    if (nivel == r->nivel_corte) {
+        Tarea* tarea = &r->tareas[r->num_tareas];
+        tarea->gen = (char*)malloc(r->indice->gen_size + 1);
+        if (tarea->gen == NULL) {
+            perror("Error de asignacion de memoria para la tarea");
+            return -1;
+        }
+        memcpy(tarea->gen, prefijo, nivel);
+        tarea->nodo = nodo;
+        tarea->nodo_compacto = nodo_compacto;
+        r->num_tareas++;
+        return 0;
+    }
+
+    const char bases[] = {'A', 'C', 'G', 'T'};
+    for (int i = 0; i < 4; i++) {
+        prefijo[nivel] = bases[i];
+        if (tc != NULL) {
+            long bit = 4 * nodo_compacto + i;
+            if (!compacto_bit(tc, bit)) continue;
+            if (generar_tareas(r, NULL, compacto_rank(tc, bit) + 1, prefijo, nivel + 1) == -1) return -1;
+        } else {
+            if (generar_tareas(r, nodo->hijos[i], 0, prefijo, nivel + 1) == -1) return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Recorre el subarbol de una tarea.
+ *
+ * @param r Recorrido al que pertenece la tarea.
+ * @param tarea Tarea a ejecutar.
+ */
+void ejecutar_tarea(Recorrido* r, Tarea* tarea) {
+    const TrieCompacto* tc = r->indice->compacto;
+    int m = r->indice->gen_size;
+
+    if (r->imprimir) {
+        if (tc != NULL) {
+            compacto_imprimir_recorrido(tc, tarea->nodo_compacto, tarea->gen,
+                                        r->nivel_corte, r->target_freq, &tarea->salida);
+        } else {
+            imprimir_recorrido(tarea->nodo, tarea->gen, r->nivel_corte, m, r->target_freq, &tarea->salida);
+        }
+    } else {
+        tarea->extremum = r->mode == 1 ? 0 : INT_MAX;
+        if (tc != NULL) {
+            compacto_recorrido_extremos(tc, tarea->nodo_compacto, r->nivel_corte,
+                                        r->mode, &tarea->extremum);
+        } else {
+            recorrido_extremos(tarea->nodo, tarea->gen, r->nivel_corte, m, r->mode, &tarea->extremum);
+        }
+    }
+}
+
+/**
+ * @brief Toma el siguiente subarbol pendiente de un recorrido.
+ *
+ * Debe llamarse con pool_mutex tomado. Cuando se toma el ultimo subarbol,
+ * el recorrido sale de la cola de pendientes.
+ *
+ * @param r Recorrido.
+ * @return Tarea a ejecutar, o NULL si ya se tomaron todas o si la siguiente
+ *         queda fuera del limite.
+ */
+Tarea* tomar_tarea(Recorrido* r) {
+    if (r->siguiente >= r->num_tareas || r->siguiente >= r->limite) return NULL;
+
+    Tarea* tarea = &r->tareas[r->siguiente++];
+    if (r->siguiente == r->num_tareas) {
+        Recorrido** actual = &pool_pendientes;
+        while (*actual != NULL && *actual != r) actual = &(*actual)->siguiente_pendiente;
+        if (*actual == r) *actual = r->siguiente_pendiente;
+    }
+    return tarea;
+}
+
+/**
+ * @brief Ejecuta una tarea fuera del mutex y avisa que termino.
+ *
+ * Debe llamarse con pool_mutex tomado; lo suelta mientras recorre.
+ *
+ * @param r Recorrido al que pertenece la tarea.
+ * @param tarea Tarea a ejecutar.
+ */
+void completar_tarea(Recorrido* r, Tarea* tarea) {
+    pthread_mutex_unlock(&pool_mutex);
+    ejecutar_tarea(r, tarea);
+    pthread_mutex_lock(&pool_mutex);
+    tarea->terminada = 1;
+    r->terminadas++;
+    pthread_cond_broadcast(&r->avance);
+}
+
+/**
+ * @brief Funcion de cada hilo del pool: atiende subarboles de cualquier recorrido.
+ *
+ * Los hilos viven mientras dure el programa. Se salta los recorridos que
+ * llegaron a su limite, y si ninguno tiene subarboles disponibles espera.
+ *
+ * @param arg No se usa.
+ * @return NULL (nunca retorna).
+ */
+void* trabajador_pool(void* arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&pool_mutex);
+    while (1) {
+        Recorrido* r = pool_pendientes;
+        Tarea* tarea = NULL;
+        while (r != NULL && (tarea = tomar_tarea(r)) == NULL) {
+            r = r->siguiente_pendiente;
+        }
+        if (tarea == NULL) {
+            pthread_cond_wait(&pool_trabajo, &pool_mutex);
+        } else {
+            completar_tarea(r, tarea);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Crea los hilos del pool la primera vez que se necesita.
+ *
+ * Se crean paralelo_num_hilos() - 1 hilos, porque el hilo que pide cada
+ * recorrido tambien recorre subarboles mientras espera.
+ */
+void iniciar_pool(void) {
+    pthread_attr_t atributos;
+    pthread_attr_init(&atributos);
+    pthread_attr_setdetachstate(&atributos, PTHREAD_CREATE_DETACHED);
+
+    int num_hilos = paralelo_num_hilos() - 1;
+    for (int i = 0; i < num_hilos; i++) {
+        pthread_t hilo;
+        if (pthread_create(&hilo, &atributos, trabajador_pool, NULL) != 0) break;
+    }
+    pthread_attr_destroy(&atributos);
+}
+
+/**
+ * @brief Espera a que termine una tarea, ayudando con el recorrido mientras tanto.
+ *
+ * Debe llamarse con pool_mutex tomado. Si quedan subarboles sin tomar, el
+ * hilo que espera los recorre el mismo, asi el recorrido avanza aunque el
+ * pool este ocupado con otros recorridos o no tenga hilos.
+ *
+ * @param r Recorrido.
+ * @param i Indice de la tarea a esperar.
+ */
+void esperar_tarea(Recorrido* r, long i) {
+    while (!r->tareas[i].terminada) {
+        Tarea* tarea = tomar_tarea(r);
+        if (tarea != NULL) {
+            completar_tarea(r, tarea);
+        } else {
+            pthread_cond_wait(&r->avance, &pool_mutex);
+        }
+    }
+}
+
+/**
+ * @brief Libera las tareas de un recorrido.
+ *
+ * @param r Recorrido a liberar; todas sus tareas deben haber terminado.
+ */
+void liberar_recorrido(Recorrido* r) {
+    for (long i = 0; i < r->num_tareas; i++) {
+        free(r->tareas[i].gen);
+        liberar_salida(&r->tareas[i].salida);
+    }
+    free(r->tareas);
+    pthread_cond_destroy(&r->avance);
+}
+
+/**
+ * @brief Divide el trie cargado en subarboles y los envia al pool.
+ *
+ * El nivel de corte es el primero con al menos PARALELO_TAREAS_POR_HILO
+ * subarboles por hilo, sin pasar del largo del gen.
+ *
+ * @param r Recorrido a preparar; indice, imprimir, mode, target_freq y limite ya asignados.
+ * @return 0 si se preparo correctamente, -1 si ocurre un error.
+ */
+int iniciar_recorrido(Recorrido* r) {
+    pthread_once(&pool_inicio, iniciar_pool);
+
+    long max_tareas = 1;
+    r->nivel_corte = 0;
+    while (r->nivel_corte < r->indice->gen_size &&
+           max_tareas < (long)paralelo_num_hilos() * PARALELO_TAREAS_POR_HILO) {
+        r->nivel_corte++;
+        max_tareas *= 4;
+    }
+
+    r->num_tareas = 0;
+    r->siguiente = 0;
+    r->terminadas = 0;
+    r->siguiente_pendiente = NULL;
+    r->tareas = (Tarea*)calloc(max_tareas, sizeof(Tarea));
+    if (r->tareas == NULL) {
+        perror("Error de asignacion de memoria para las tareas");
+        return -1;
+    }
+    pthread_cond_init(&r->avance, NULL);
+
+    char prefijo[32];
+    if (generar_tareas(r, r->indice->raiz, 0, prefijo, 0) == -1) {
+        liberar_recorrido(r);
+        return -1;
+    }
+
+    if (r->num_tareas > 0) {
+        pthread_mutex_lock(&pool_mutex);
+        Recorrido** ultimo = &pool_pendientes;
+        while (*ultimo != NULL) ultimo = &(*ultimo)->siguiente_pendiente;
+        *ultimo = r;
+        pthread_cond_broadcast(&pool_trabajo);
+        pthread_mutex_unlock(&pool_mutex);
+    }
+    return 0;
+}
+
+/**
+ * @brief Calcula la frecuencia maxima o minima repartiendo los subarboles.
+ *
+ * Cada subarbol guarda su propio extremo y al final se combinan.
+ *
+ * @param indice Indice cargado.
+ * @param mode 1 = max, 0 = min.
+ * @return Frecuencia extrema o -1 si ocurre un error.
+ */
+int paralelo_extremo(const Indice* indice, int mode) {
+    Recorrido r;
+    r.indice = indice;
+    r.imprimir = 0;
+    r.mode = mode;
+    r.target_freq = 0;
+    r.limite = LONG_MAX;
+
+    if (iniciar_recorrido(&r) == -1) return -1;
+
+    pthread_mutex_lock(&pool_mutex);
+    for (long i = 0; i < r.num_tareas; i++) {
+        esperar_tarea(&r, i);
+    }
+    pthread_mutex_unlock(&pool_mutex);
+
+    int extremum = mode == 1 ? 0 : INT_MAX;
+    for (long i = 0; i < r.num_tareas; i++) {
+        int valor = r.tareas[i].extremum;
+        if (mode == 1) {
+            if (valor > extremum) extremum = valor;
+        } else {
+            if (valor < extremum) extremum = valor;
+        }
+    }
+
+    liberar_recorrido(&r);
+    return extremum;
+}
+
+/**
+ * @brief Escribe los genes repartiendo los subarboles entre los hilos.
+ *
+ * El hilo que pide el recorrido escribe la salida de cada subarbol en orden
+ * apenas termina, por lo que el resultado queda en orden lexicografico. Si
+ * el buffer de un subarbol quedo incompleto, no se escribe nada mas. Solo
+ * se toman subarboles dentro de una ventana de PARALELO_VENTANA_POR_HILO
+ * por hilo desde el que se espera, asi la salida en memoria queda acotada.
+ *
+ * @param indice Indice cargado.
+ * @param target_freq Frecuencia a imprimir, o 0 para todos.
+ * @param destino Archivo de destino.
+ * @return 0 si se imprimio correctamente, -1 si ocurre un error.
+ */
+int paralelo_imprimir(const Indice* indice, int target_freq, FILE* destino) {
+    Recorrido r;
+    r.indice = indice;
+    r.imprimir = 1;
+    r.mode = 0;
+    r.target_freq = target_freq;
+    long ventana = (long)paralelo_num_hilos() * PARALELO_VENTANA_POR_HILO;
+    r.limite = ventana;
+
+    if (iniciar_recorrido(&r) == -1) return -1;
+
+    int resultado = 0;
+    for (long i = 0; i < r.num_tareas; i++) {
+        pthread_mutex_lock(&pool_mutex);
+        if (i + ventana > r.limite) {
+            r.limite = i + ventana;
+            pthread_cond_broadcast(&pool_trabajo);
+        }
+        esperar_tarea(&r, i);
+        pthread_mutex_unlock(&pool_mutex);
+        if (r.tareas[i].salida.error) resultado = -1;
+        if (resultado == 0) salida_volcar(&r.tareas[i].salida, destino);
+        liberar_salida(&r.tareas[i].salida);
+    }
+
+    liberar_recorrido(&r);
+    return resultado;
+}
@@ -0,0 +1,58 @@
+#ifndef RECORRIDO_PARALELO_H
+#define RECORRIDO_PARALELO_H
+
+#include "trie.h"
+#include <stdio.h>
+
+/**
+ * @brief Subarboles que se intentan generar por cada hilo.
+ *
+ * Se corta el trie en el primer nivel que tenga al menos esta cantidad de
+ * subarboles por hilo, para que los hilos que terminan antes tomen el
+ * trabajo restante cuando el arbol esta desbalanceado.
+ */
+#define PARALELO_TAREAS_POR_HILO 8
+
+/**
+ * @brief Maximo de hilos usados en los recorridos.
+ *
+ * Los recorridos comparten un unico pool de hilos que se crea la primera
+ * vez que se usa y vive mientras dure el programa, por lo que el total de
+ * hilos queda acotado aunque haya varios recorridos a la vez.
+ */
+#define PARALELO_MAX_HILOS 64
+
+/**
+ * @brief Subarboles por hilo que puede adelantarse una impresion.
+ *
+ * Al imprimir, solo se toman subarboles hasta esta cantidad por hilo mas
+ * alla del siguiente que se escribe, para acotar la salida guardada en
+ * memoria mientras se espera a los anteriores.
+ */
+#define PARALELO_VENTANA_POR_HILO 2
+
+/**
+ * @brief Cantidad de hilos que se usan en los recorridos.
+ * @return Numero de procesadores disponibles, entre 1 y PARALELO_MAX_HILOS.
+ */
+int paralelo_num_hilos(void);
+
+/**
+ * @brief Calcula en paralelo la frecuencia maxima o minima del trie cargado.
+ * @param indice Indice cargado.
+ * @param mode 1 = max, 0 = min.
+ * @return Frecuencia extrema (0 para max o INT_MAX para min si no hay genes),
+ *         o -1 si ocurre un error.
+ */
+int paralelo_extremo(const Indice* indice, int mode);
+
+/**
+ * @brief Imprime en paralelo, y en orden lexicografico, los genes del trie.
+ * @param indice Indice cargado.
+ * @param target_freq Frecuencia a imprimir, o 0 para todos los genes presentes.
+ * @param destino Archivo donde se escribe el resultado.
+ * @return 0 si se imprimio correctamente, -1 si ocurre un error.
+ */
+int paralelo_imprimir(const Indice* indice, int target_freq, FILE* destino);
+
+#endif
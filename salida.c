@@ -0,0 +1,73 @@
+#include "salida.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Agrega texto con formato al final del buffer.
+ *
+ * Si el texto no cabe, el buffer se agranda al doble de lo necesario.
+ * Si falla una escritura se marca el error y las siguientes se ignoran,
+ * para no dejar lineas cortadas a la mitad.
+ *
+ * @param salida Buffer de destino.
+ * @param formato Formato estilo printf.
+ * @return 0 si se agrego correctamente, -1 si falla la asignacion.
+ */
+int salida_printf(Salida* salida, const char* formato, ...) {
+    if (salida->error) return -1;
+
+    va_list args;
+    va_start(args, formato);
+    int necesario = vsnprintf(NULL, 0, formato, args);
+    va_end(args);
+    if (necesario < 0) {
+        salida->error = 1;
+        return -1;
+    }
+
+    if (salida->largo + necesario + 1 > salida->capacidad) {
+        size_t nueva = (salida->largo + necesario + 1) * 2;
+        if (nueva < 256) nueva = 256;
+        char* datos = (char*)realloc(salida->datos, nueva);
+        if (datos == NULL) {
+            perror("Error de asignacion de memoria para Salida");
+            salida->error = 1;
+            return -1;
+        }
+        salida->datos = datos;
+        salida->capacidad = nueva;
+    }
+
+    va_start(args, formato);
+    vsnprintf(salida->datos + salida->largo, necesario + 1, formato, args);
+    va_end(args);
+    salida->largo += necesario;
+    return 0;
+}
+
+/**
+ * @brief Escribe el contenido del buffer en un archivo y lo vacia.
+ *
+ * @param salida Buffer a escribir.
+ * @param destino Archivo de destino.
+ */
+void salida_volcar(Salida* salida, FILE* destino) {
+    if (salida->largo > 0) {
+        fwrite(salida->datos, 1, salida->largo, destino);
+    }
+    salida->largo = 0;
+}
+
+/**
+ * @brief Libera la memoria del buffer y lo deja vacio.
+ *
+ * @param salida Buffer a liberar.
+ */
+void liberar_salida(Salida* salida) {
+    free(salida->datos);
+    salida->datos = NULL;
+    salida->largo = 0;
+    salida->capacidad = 0;
+    salida->error = 0;
+}
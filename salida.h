@@ -0,0 +1,42 @@
+#ifndef SALIDA_H
+#define SALIDA_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief Buffer de texto que crece segun se necesite.
+ *
+ * Permite que cada hilo arme su parte de la salida por separado para
+ * luego imprimirla en orden.
+ */
+typedef struct Salida {
+    char* datos;        /**< Texto acumulado, terminado en '\0' */
+    size_t largo;       /**< Caracteres escritos */
+    size_t capacidad;   /**< Bytes reservados en datos */
+    int error;          /**< 1 si alguna escritura fallo y el texto quedo incompleto */
+} Salida;
+
+/**
+ * @brief Agrega texto con formato al final del buffer.
+ * @param salida Buffer de destino.
+ * @param formato Formato estilo printf.
+ * @return 0 si se agrego correctamente, -1 si falla la asignacion o el
+ *         buffer ya tenia un error.
+ */
+int salida_printf(Salida* salida, const char* formato, ...);
+
+/**
+ * @brief Escribe el contenido del buffer en un archivo y lo vacia.
+ * @param salida Buffer a escribir.
+ * @param destino Archivo de destino.
+ */
+void salida_volcar(Salida* salida, FILE* destino);
+
+/**
+ * @brief Libera la memoria del buffer.
+ * @param salida Buffer a liberar.
+ */
+void liberar_salida(Salida* salida);
+
+#endif
@@ -0,0 +1,290 @@
+#include "secuencia.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// En x86 con GCC o Clang la version AVX2 se compila siempre y se elige al ejecutar
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SECUENCIA_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Obtiene el codigo de 2 bits de un caracter, sin importar mayusculas.
+ *
+ * Al apagar el bit 0x20 solo 'A' y 'a' quedan como 'A' (igual para C, G y T).
+ *
+ * @param c Caracter leido.
+ * @return Indice 0-3 o -1 si no es una base.
+ */
+int codigo_base(unsigned char c) {
+    switch (c & 0xDF) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default: return -1;
+    }
+}
+
+#if defined(SECUENCIA_AVX2) || defined(__SSE2__)
+/**
+ * @brief Separa los bits de un entero de 32 bits dejando uno vacio entre cada uno.
+ *
+ * El bit i pasa a la posicion 2i, para combinar los dos bits de cada base.
+ *
+ * @param x Bits a separar.
+ * @return Bits en las posiciones pares.
+ */
+uint64_t intercalar_bits(uint64_t x) {
+    x &= 0xFFFFFFFFULL;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8))  & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2))  & 0x3333333333333333ULL;
+    x = (x | (x << 1))  & 0x5555555555555555ULL;
+    return x;
+}
+
+/**
+ * @brief Guarda un grupo de bases a partir de las mascaras de comparacion.
+ *
+ * @param secuencia Secuencia de destino.
+ * @param pos Posicion de la primera base, multiplo de la cantidad de bases.
+ * @param cantidad Bases del grupo (16 o 32).
+ * @param bit_bajo Bit menos significativo de cada base (C o T).
+ * @param bit_alto Bit mas significativo de cada base (G o T).
+ * @param invalidos Bit en 1 para cada caracter que no es una base.
+ */
+void guardar_grupo(SecuenciaEmpaquetada* secuencia, long pos, int cantidad,
+                   uint32_t bit_bajo, uint32_t bit_alto, uint32_t invalidos) {
+    uint64_t empaquetado = intercalar_bits(bit_bajo) | (intercalar_bits(bit_alto) << 1);
+    for (int k = 0; k < cantidad / 4; k++) {
+        secuencia->bases[(pos >> 2) + k] = (uint8_t)(empaquetado >> (8 * k));
+    }
+    secuencia->invalidos[pos >> 6] |= (uint64_t)invalidos << (pos & 63);
+}
+#endif
+
+#if defined(SECUENCIA_AVX2)
+/**
+ * @brief Empaqueta grupos de 32 caracteres con AVX2.
+ *
+ * Se compila con soporte AVX2 aunque el resto del programa no lo tenga;
+ * solo se llama si el procesador lo admite.
+ *
+ * @param secuencia Secuencia de destino, con espacio reservado.
+ * @param datos Caracteres del bloque.
+ * @param n Cantidad de caracteres.
+ * @param inicio Posicion del primer caracter, multiplo de 64.
+ * @return Cantidad de caracteres procesados, multiplo de 32.
+ */
+__attribute__((target("avx2")))
+long empaquetar_avx2(SecuenciaEmpaquetada* secuencia, const char* datos, long n, long inicio) {
+    const __m256i mayuscula = _mm256_set1_epi8((char)0xDF);
+    const __m256i base_a = _mm256_set1_epi8('A');
+    const __m256i base_c = _mm256_set1_epi8('C');
+    const __m256i base_g = _mm256_set1_epi8('G');
+    const __m256i base_t = _mm256_set1_epi8('T');
+    long i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(datos + i)), mayuscula);
+        __m256i es_a = _mm256_cmpeq_epi8(v, base_a);
+        __m256i es_c = _mm256_cmpeq_epi8(v, base_c);
+        __m256i es_g = _mm256_cmpeq_epi8(v, base_g);
+        __m256i es_t = _mm256_cmpeq_epi8(v, base_t);
+        uint32_t bajo = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(es_c, es_t));
+        uint32_t alto = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(es_g, es_t));
+        uint32_t validos = (uint32_t)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_or_si256(es_a, es_c), _mm256_or_si256(es_g, es_t)));
+        guardar_grupo(secuencia, inicio + i, 32, bajo, alto, ~validos);
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief Agranda los arreglos de la secuencia para que quepan n posiciones mas.
+ *
+ * La memoria nueva queda en cero.
+ *
+ * @param secuencia Secuencia a agrandar.
+ * @param n Posiciones que se van a agregar.
+ * @return 0 si hay espacio, -1 si falla la asignacion.
+ */
+int reservar_secuencia(SecuenciaEmpaquetada* secuencia, long n) {
+    if (secuencia->largo + n <= secuencia->capacidad) return 0;
+
+    long nueva = secuencia->capacidad > 0 ? secuencia->capacidad * 2 : SECUENCIA_BLOQUE;
+    while (nueva < secuencia->largo + n) nueva *= 2;
+
+    uint8_t* bases = (uint8_t*)realloc(secuencia->bases, nueva / 4);
+    if (bases == NULL) return -1;
+    memset(bases + secuencia->capacidad / 4, 0, (nueva - secuencia->capacidad) / 4);
+    secuencia->bases = bases;
+
+    uint64_t* invalidos = (uint64_t*)realloc(secuencia->invalidos, (nueva / 64) * sizeof(uint64_t));
+    if (invalidos == NULL) return -1;
+    memset(invalidos + secuencia->capacidad / 64, 0, ((nueva - secuencia->capacidad) / 64) * sizeof(uint64_t));
+    secuencia->invalidos = invalidos;
+
+    secuencia->capacidad = nueva;
+    return 0;
+}
+
+/**
+ * @brief Valida, pasa a mayusculas y empaqueta un bloque de caracteres.
+ *
+ * Cada grupo de 32 (AVX2, si el procesador lo admite) o 16 (SSE2)
+ * caracteres se compara a la vez con las cuatro bases; las mascaras
+ * resultantes dan directamente los dos bits de cada base y el bitmap de
+ * invalidos. Los caracteres sobrantes se procesan uno por uno.
+ *
+ * @param secuencia Secuencia de destino.
+ * @param datos Caracteres del bloque.
+ * @param n Cantidad de caracteres.
+ * @return 0 si se agrego correctamente, -1 si falla la asignacion.
+ */
+int empaquetar_bloque(SecuenciaEmpaquetada* secuencia, const char* datos, long n) {
+    if (reservar_secuencia(secuencia, n) == -1) {
+        perror("Error de asignacion de memoria para la secuencia");
+        return -1;
+    }
+
+    long inicio = secuencia->largo;
+    long i = 0;
+
+#if defined(SECUENCIA_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        i = empaquetar_avx2(secuencia, datos, n, inicio);
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i mayuscula = _mm_set1_epi8((char)0xDF);
+    const __m128i base_a = _mm_set1_epi8('A');
+    const __m128i base_c = _mm_set1_epi8('C');
+    const __m128i base_g = _mm_set1_epi8('G');
+    const __m128i base_t = _mm_set1_epi8('T');
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(datos + i)), mayuscula);
+        __m128i es_a = _mm_cmpeq_epi8(v, base_a);
+        __m128i es_c = _mm_cmpeq_epi8(v, base_c);
+        __m128i es_g = _mm_cmpeq_epi8(v, base_g);
+        __m128i es_t = _mm_cmpeq_epi8(v, base_t);
+        uint32_t bajo = (uint32_t)_mm_movemask_epi8(_mm_or_si128(es_c, es_t));
+        uint32_t alto = (uint32_t)_mm_movemask_epi8(_mm_or_si128(es_g, es_t));
+        uint32_t validos = (uint32_t)_mm_movemask_epi8(
+            _mm_or_si128(_mm_or_si128(es_a, es_c), _mm_or_si128(es_g, es_t)));
+        guardar_grupo(secuencia, inicio + i, 16, bajo, alto, ~validos & 0xFFFFu);
+    }
+#endif
+
+    for (; i < n; i++) {
+        long pos = inicio + i;
+        int codigo = codigo_base((unsigned char)datos[i]);
+        if (codigo == -1) {
+            secuencia->invalidos[pos >> 6] |= (uint64_t)1 << (pos & 63);
+        } else {
+            secuencia->bases[pos >> 2] |= (uint8_t)(codigo << ((pos & 3) * 2));
+        }
+    }
+
+    secuencia->largo += n;
+    return 0;
+}
+
+/**
+ * @brief Lee el archivo en bloques de SECUENCIA_BLOQUE caracteres.
+ *
+ * Solo se mantiene en memoria un bloque de texto a la vez; la secuencia
+ * completa queda empaquetada.
+ *
+ * @param nombre_archivo Nombre del archivo a leer.
+ * @return Secuencia empaquetada o NULL en caso de error.
+ */
+SecuenciaEmpaquetada* leer_secuencia(const char* nombre_archivo) {
+    FILE* file = fopen(nombre_archivo, "r");
+    if (file == NULL) {
+        perror("Error al abrir el archivo");
+        return NULL;
+    }
+
+    SecuenciaEmpaquetada* secuencia = (SecuenciaEmpaquetada*)calloc(1, sizeof(SecuenciaEmpaquetada));
+    char* bloque = (char*)malloc(SECUENCIA_BLOQUE);
+    if (secuencia == NULL || bloque == NULL) {
+        perror("Error de asignacion de memoria para S");
+        free(secuencia);
+        free(bloque);
+        fclose(file);
+        return NULL;
+    }
+
+    long largo_util = 0;
+    size_t leidos;
+    do {
+        // Se llena el bloque completo para que el siguiente empiece en un multiplo de 64
+        leidos = 0;
+        size_t n;
+        while (leidos < SECUENCIA_BLOQUE &&
+               (n = fread(bloque + leidos, 1, SECUENCIA_BLOQUE - leidos, file)) > 0) {
+            leidos += n;
+        }
+
+        long inicio = secuencia->largo;
+        if (leidos > 0 && empaquetar_bloque(secuencia, bloque, (long)leidos) == -1) {
+            liberar_secuencia(secuencia);
+            free(bloque);
+            fclose(file);
+            return NULL;
+        }
+
+        for (long i = (long)leidos - 1; i >= 0; i--) {
+            if (bloque[i] != '\n' && bloque[i] != '\r' && bloque[i] != ' ' && bloque[i] != '\t') {
+                largo_util = inicio + i + 1;
+                break;
+            }
+        }
+    } while (leidos == SECUENCIA_BLOQUE);
+
+    free(bloque);
+    fclose(file);
+    secuencia->largo = largo_util;
+    return secuencia;
+}
+
+/**
+ * @brief Obtiene la base de una posicion.
+ *
+ * @param secuencia Secuencia empaquetada.
+ * @param i Posicion.
+ * @return Indice de la base entre 0 y 3.
+ */
+int secuencia_base(const SecuenciaEmpaquetada* secuencia, long i) {
+    return (secuencia->bases[i >> 2] >> ((i & 3) * 2)) & 3;
+}
+
+/**
+ * @brief Indica si una posicion tiene un caracter invalido.
+ *
+ * @param secuencia Secuencia empaquetada.
+ * @param i Posicion.
+ * @return 1 si es invalida, 0 si es una base.
+ */
+int secuencia_invalida(const SecuenciaEmpaquetada* secuencia, long i) {
+    return (int)((secuencia->invalidos[i >> 6] >> (i & 63)) & 1);
+}
+
+/**
+ * @brief Libera los arreglos y la estructura de la secuencia.
+ *
+ * @param secuencia Secuencia a liberar.
+ */
+void liberar_secuencia(SecuenciaEmpaquetada* secuencia) {
+    if (secuencia == NULL) return;
+
+    free(secuencia->bases);
+    free(secuencia->invalidos);
+    free(secuencia);
+}
@@ -0,0 +1,80 @@
+#ifndef SECUENCIA_H
+#define SECUENCIA_H
+
+#include <stdint.h>
+
+/**
+ * @brief Bases que se leen del archivo en cada bloque.
+ *
+ * Debe ser multiplo de 64 para que cada bloque empiece en una palabra
+ * nueva del bitmap de invalidos.
+ */
+#define SECUENCIA_BLOQUE 65536
+
+/**
+ * @brief Secuencia S empaquetada con 2 bits por base.
+ *
+ * Cada byte guarda 4 bases (A=0, C=1, G=2, T=3), empezando por los bits
+ * menos significativos. Las posiciones con un caracter que no es una base
+ * se marcan en el bitmap de invalidos y se guardan como 0.
+ */
+typedef struct SecuenciaEmpaquetada {
+    uint8_t* bases;        /**< Bases empaquetadas, 4 por byte */
+    uint64_t* invalidos;   /**< Bitmap con 1 en las posiciones invalidas */
+    long largo;            /**< Cantidad de posiciones de la secuencia */
+    long capacidad;        /**< Posiciones reservadas, multiplo de 64 */
+} SecuenciaEmpaquetada;
+
+/**
+ * @brief Obtiene el codigo de 2 bits de un caracter, sin importar mayusculas.
+ * @param c Caracter leido.
+ * @return Indice 0-3 o -1 si no es una base.
+ */
+int codigo_base(unsigned char c);
+
+/**
+ * @brief Valida, pasa a mayusculas y empaqueta un bloque de caracteres.
+ *
+ * Usa AVX2 si el procesador lo admite (se detecta al ejecutar), si no SSE2
+ * cuando el compilador lo habilita, y procesa el resto base por base.
+ *
+ * @param secuencia Secuencia a la que se agrega el bloque; su largo debe ser multiplo de 64.
+ * @param datos Caracteres leidos del archivo.
+ * @param n Cantidad de caracteres.
+ * @return 0 si se agrego correctamente, -1 si falla la asignacion.
+ */
+int empaquetar_bloque(SecuenciaEmpaquetada* secuencia, const char* datos, long n);
+
+/**
+ * @brief Lee un archivo de ADN por bloques y lo empaqueta.
+ *
+ * Los espacios y saltos de linea al final del archivo no se cuentan.
+ *
+ * @param nombre_archivo Nombre del archivo a leer.
+ * @return Secuencia empaquetada o NULL en caso de error.
+ */
+SecuenciaEmpaquetada* leer_secuencia(const char* nombre_archivo);
+
+/**
+ * @brief Obtiene la base de una posicion.
+ * @param secuencia Secuencia empaquetada.
+ * @param i Posicion.
+ * @return Indice de la base entre 0 y 3.
+ */
+int secuencia_base(const SecuenciaEmpaquetada* secuencia, long i);
+
+/**
+ * @brief Indica si una posicion tiene un caracter invalido.
+ * @param secuencia Secuencia empaquetada.
+ * @param i Posicion.
+ * @return 1 si es invalida, 0 si es una base.
+ */
+int secuencia_invalida(const SecuenciaEmpaquetada* secuencia, long i);
+
+/**
+ * @brief Libera la secuencia empaquetada.
+ * @param secuencia Secuencia a liberar.
+ */
+void liberar_secuencia(SecuenciaEmpaquetada* secuencia);
+
+#endif
@@ -0,0 +1,402 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "servidor.h"
+#include "trie.h"
+#include "trie_compacto.h"
+#include "recorrido_paralelo.h"
+#include "salida.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief Datos que recibe el hilo de cada cliente.
+ */
+typedef struct Cliente {
+    int fd;                       /**< Socket conectado con el cliente */
+    const Indice* indice;         /**< Indice compartido de solo lectura */
+    struct Cliente* siguiente;    /**< Siguiente cliente conectado */
+} Cliente;
+
+/// Se activa con SIGINT o SIGTERM para dejar de aceptar clientes
+static volatile sig_atomic_t terminar_servidor = 0;
+
+/// Tuberia donde el manejador de senales escribe para despertar a poll()
+static int tuberia_senal[2] = {-1, -1};
+
+/// Protege la lista de clientes conectados
+static pthread_mutex_t clientes_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// Se avisa cada vez que un cliente se desconecta
+static pthread_cond_t clientes_fin = PTHREAD_COND_INITIALIZER;
+
+/// Clientes cuyo hilo todavia puede leer el indice
+static Cliente* clientes_activos = NULL;
+
+/**
+ * @brief Marca el servidor para terminar y despierta el ciclo de aceptacion.
+ *
+ * @param senal Senal recibida.
+ */
+void manejar_senal(int senal) {
+    (void)senal;
+    int errno_guardado = errno;
+    terminar_servidor = 1;
+    ssize_t escrito = write(tuberia_senal[1], "x", 1);
+    (void)escrito;
+    errno = errno_guardado;
+}
+
+/**
+ * @brief Responde una consulta y escribe la linea vacia que la cierra.
+ *
+ * @param indice Indice cargado.
+ * @param linea Consulta sin salto de linea.
+ * @param destino Archivo de respuesta.
+ */
+void responder_consulta(const Indice* indice, const char* linea, FILE* destino) {
+    char comando[16], arg1[SERVIDOR_MAX_LINEA], formato[32];
+    snprintf(formato, sizeof(formato), "%%15s %%%ds", SERVIDOR_MAX_LINEA - 1);
+    int num_args = sscanf(linea, formato, comando, arg1);
+
+    if (num_args == 2 && strcmp(comando, "search") == 0) {
+        int validez = validar_gen(indice, arg1);
+        if (validez == -1) {
+            fprintf(destino, "ERROR el gen debe tener largo %d\n", indice->gen_size);
+        } else if (validez == -2) {
+            fprintf(destino, "ERROR caracter invalido en %s\n", arg1);
+        } else {
+            ListaInt* lista = indice_buscar(indice, arg1);
+            int frecuencia = contar_posiciones(lista);
+            if (frecuencia == 0) {
+                fprintf(destino, "%s -1\n", arg1);
+            } else {
+                Salida salida = {NULL, 0, 0, 0};
+                salida_printf(&salida, "%s %d", arg1, frecuencia);
+                escribir_posiciones(lista, &salida);
+                if (salida_printf(&salida, "\n") == -1) {
+                    fprintf(destino, "ERROR no se pudo generar la respuesta\n");
+                } else {
+                    salida_volcar(&salida, destino);
+                }
+                liberar_salida(&salida);
+            }
+        }
+
+    } else if (num_args == 1 && (strcmp(comando, "max") == 0 || strcmp(comando, "min") == 0)) {
+        int mode = strcmp(comando, "max") == 0 ? 1 : 0;
+        int extremum = paralelo_extremo(indice, mode);
+        if (extremum == -1) {
+            fprintf(destino, "ERROR no se pudo recorrer el indice\n");
+        } else if (extremum != 0 && extremum != INT_MAX) {
+            if (paralelo_imprimir(indice, extremum, destino) == -1) {
+                fprintf(destino, "ERROR no se pudo recorrer el indice\n");
+            }
+        }
+
+    } else if (num_args == 1 && strcmp(comando, "all") == 0) {
+        if (paralelo_imprimir(indice, 0, destino) == -1) {
+            fprintf(destino, "ERROR no se pudo recorrer el indice\n");
+        }
+
+    } else {
+        fprintf(destino, "ERROR comando invalido\n");
+    }
+
+    fprintf(destino, "\n");
+    fflush(destino);
+}
+
+/**
+ * @brief Saca un cliente de la lista de conectados y avisa al servidor.
+ *
+ * Despues de esto el cliente ya no lee el indice y su socket no se vuelve
+ * a usar desde otro hilo.
+ *
+ * @param cliente Cliente a quitar.
+ */
+void quitar_cliente(Cliente* cliente) {
+    pthread_mutex_lock(&clientes_mutex);
+    Cliente** actual = &clientes_activos;
+    while (*actual != NULL && *actual != cliente) actual = &(*actual)->siguiente;
+    if (*actual == cliente) *actual = cliente->siguiente;
+    pthread_cond_broadcast(&clientes_fin);
+    pthread_mutex_unlock(&clientes_mutex);
+}
+
+/**
+ * @brief Corta la conexion de todos los clientes y espera a que terminen.
+ *
+ * shutdown() hace que las lecturas pendientes terminen y las escrituras
+ * fallen, asi cada hilo sale de su ciclo y deja de usar el indice.
+ */
+void detener_clientes(void) {
+    pthread_mutex_lock(&clientes_mutex);
+    for (Cliente* cliente = clientes_activos; cliente != NULL; cliente = cliente->siguiente) {
+        shutdown(cliente->fd, SHUT_RDWR);
+    }
+    while (clientes_activos != NULL) {
+        pthread_cond_wait(&clientes_fin, &clientes_mutex);
+    }
+    pthread_mutex_unlock(&clientes_mutex);
+}
+
+/**
+ * @brief Atiende las consultas de un cliente hasta que cierre la conexion.
+ *
+ * @param arg Puntero a un Cliente ya agregado a la lista de conectados; se
+ *            quita y se libera al terminar.
+ * @return NULL.
+ */
+void* atender_cliente(void* arg) {
+    Cliente* cliente = (Cliente*)arg;
+
+    FILE* entrada = fdopen(cliente->fd, "r");
+    int fd_salida = dup(cliente->fd);
+    FILE* salida = fd_salida == -1 ? NULL : fdopen(fd_salida, "w");
+    if (entrada == NULL || salida == NULL) {
+        perror("Error al abrir la conexion con el cliente");
+        quitar_cliente(cliente);
+        if (entrada != NULL) fclose(entrada);
+        else close(cliente->fd);
+        if (salida != NULL) fclose(salida);
+        else if (fd_salida != -1) close(fd_salida);
+        free(cliente);
+        return NULL;
+    }
+
+    char linea[SERVIDOR_MAX_LINEA];
+    while (fgets(linea, sizeof(linea), entrada) != NULL) {
+        // Si la linea no cupo, se descarta el resto y se responde un solo error
+        if (strchr(linea, '\n') == NULL && strlen(linea) == sizeof(linea) - 1) {
+            int c = fgetc(entrada);
+            if (c != '\n' && c != EOF) {
+                while (c != '\n' && c != EOF) c = fgetc(entrada);
+                fprintf(salida, "ERROR linea demasiado larga\n\n");
+                fflush(salida);
+                if (ferror(salida)) break;
+                continue;
+            }
+        }
+        linea[strcspn(linea, "\r\n")] = 0;
+        if (strcmp(linea, "quit") == 0) break;
+        responder_consulta(cliente->indice, linea, salida);
+        if (ferror(salida)) break;
+    }
+
+    quitar_cliente(cliente);
+    fclose(salida);
+    fclose(entrada);
+    free(cliente);
+    return NULL;
+}
+
+/**
+ * @brief Crea el socket Unix y lo deja escuchando.
+ *
+ * Si la ruta ya existe y es un socket (de una ejecucion anterior) se
+ * reemplaza; cualquier otro archivo se deja intacto.
+ *
+ * @param ruta_socket Ruta del socket.
+ * @return Descriptor del socket o -1 si ocurre un error.
+ */
+int abrir_socket(const char* ruta_socket) {
+    struct sockaddr_un direccion;
+    if (strlen(ruta_socket) >= sizeof(direccion.sun_path)) {
+        printf("%sError: La ruta del socket es demasiado larga.\n%s", ROJO, RESET);
+        return -1;
+    }
+
+    struct stat info;
+    if (lstat(ruta_socket, &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            printf("%sError: %s ya existe y no es un socket.\n%s", ROJO, ruta_socket, RESET);
+            return -1;
+        }
+        unlink(ruta_socket);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        perror("Error al crear el socket");
+        return -1;
+    }
+
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    strcpy(direccion.sun_path, ruta_socket);
+    if (bind(fd, (struct sockaddr*)&direccion, sizeof(direccion)) == -1) {
+        perror("Error al asociar el socket");
+        close(fd);
+        return -1;
+    }
+    if (listen(fd, SOMAXCONN) == -1) {
+        perror("Error al escuchar en el socket");
+        close(fd);
+        unlink(ruta_socket);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Espera el siguiente cliente o una senal de termino.
+ *
+ * poll() vigila el socket y la tuberia de senales a la vez, asi una senal
+ * que llega antes de esperar no se pierde. Si se agotan los descriptores,
+ * se avisa una vez y se reintenta cada SERVIDOR_PAUSA_ACEPTAR_MS; otros
+ * errores de accept() detienen el servidor.
+ *
+ * @param fd_servidor Socket que escucha, en modo no bloqueante.
+ * @return Descriptor del cliente, o -1 si el servidor debe terminar.
+ */
+int aceptar_cliente(int fd_servidor) {
+    struct pollfd esperas[2];
+    esperas[0].fd = fd_servidor;
+    esperas[0].events = POLLIN;
+    esperas[1].fd = tuberia_senal[0];
+    esperas[1].events = POLLIN;
+    int sin_recursos = 0;
+
+    while (!terminar_servidor) {
+        if (poll(esperas, 2, -1) == -1) {
+            if (errno == EINTR) continue;
+            perror("Error al esperar clientes");
+            return -1;
+        }
+        if (esperas[1].revents != 0) return -1;
+        if (esperas[0].revents == 0) continue;
+
+        int fd_cliente = accept(fd_servidor, NULL, NULL);
+        if (fd_cliente != -1) return fd_cliente;
+
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED) {
+            continue;
+        }
+        if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+            if (!sin_recursos) perror("Error al aceptar un cliente");
+            sin_recursos = 1;
+            poll(&esperas[1], 1, SERVIDOR_PAUSA_ACEPTAR_MS);
+            continue;
+        }
+        perror("Error al aceptar un cliente");
+        return -1;
+    }
+    return -1;
+}
+
+/**
+ * @brief Carga el indice y atiende clientes hasta recibir SIGINT o SIGTERM.
+ *
+ * @param ruta_socket Ruta del socket a crear.
+ * @param m Largo de los genes.
+ * @param nombre_archivo Archivo con la secuencia S.
+ * @param compactar 1 para construir el indice directamente en forma compacta.
+ * @return 0 al terminar, -1 si ocurre un error al iniciar.
+ */
+int bio_serve(const char* ruta_socket, int m, const char* nombre_archivo, int compactar) {
+    Indice indice = {NULL, NULL, 0, 0};
+
+    // El indice compacto se arma desde la secuencia, sin el arbol completo
+    if (compactar) {
+        if (bio_start_compacto(&indice, m) == -1) return -1;
+    } else if (bio_start(&indice, m) == NULL) {
+        return -1;
+    }
+    if (bio_read(&indice, nombre_archivo) == -1) {
+        liberar_indice(&indice);
+        return -1;
+    }
+
+    int fd_servidor = abrir_socket(ruta_socket);
+    if (fd_servidor == -1) {
+        liberar_indice(&indice);
+        return -1;
+    }
+    if (pipe(tuberia_senal) == -1) {
+        perror("Error al crear la tuberia de senales");
+        close(fd_servidor);
+        unlink(ruta_socket);
+        liberar_indice(&indice);
+        return -1;
+    }
+    fcntl(tuberia_senal[1], F_SETFL, O_NONBLOCK);
+    fcntl(fd_servidor, F_SETFL, O_NONBLOCK);
+
+    struct sigaction accion;
+    memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = manejar_senal;
+    sigemptyset(&accion.sa_mask);
+    sigaction(SIGINT, &accion, NULL);
+    sigaction(SIGTERM, &accion, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("%sEscuchando en %s\n%s", AMARILLO, ruta_socket, RESET);
+    fflush(stdout);
+
+    pthread_attr_t atributos;
+    pthread_attr_init(&atributos);
+    pthread_attr_setdetachstate(&atributos, PTHREAD_CREATE_DETACHED);
+
+    // Los hilos de clientes (y el pool que crean) heredan las senales
+    // bloqueadas, asi SIGINT y SIGTERM siempre llegan al hilo principal
+    sigset_t senales_termino, senales_anteriores;
+    sigemptyset(&senales_termino);
+    sigaddset(&senales_termino, SIGINT);
+    sigaddset(&senales_termino, SIGTERM);
+
+    while (1) {
+        int fd_cliente = aceptar_cliente(fd_servidor);
+        if (fd_cliente == -1) break;
+
+        Cliente* cliente = (Cliente*)malloc(sizeof(Cliente));
+        if (cliente == NULL) {
+            perror("Error de asignacion de memoria para Cliente");
+            close(fd_cliente);
+            continue;
+        }
+        cliente->fd = fd_cliente;
+        cliente->indice = &indice;
+
+        pthread_mutex_lock(&clientes_mutex);
+        cliente->siguiente = clientes_activos;
+        clientes_activos = cliente;
+        pthread_mutex_unlock(&clientes_mutex);
+
+        pthread_t hilo;
+        pthread_sigmask(SIG_BLOCK, &senales_termino, &senales_anteriores);
+        int creado = pthread_create(&hilo, &atributos, atender_cliente, cliente);
+        pthread_sigmask(SIG_SETMASK, &senales_anteriores, NULL);
+        if (creado != 0) {
+            printf("%sError: No se pudo crear el hilo del cliente.\n%s", ROJO, RESET);
+            quitar_cliente(cliente);
+            close(fd_cliente);
+            free(cliente);
+        }
+    }
+
+    pthread_attr_destroy(&atributos);
+    close(fd_servidor);
+    unlink(ruta_socket);
+
+    // El indice se libera solo cuando ningun cliente puede seguir leyendolo
+    detener_clientes();
+    liberar_indice(&indice);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    close(tuberia_senal[0]);
+    close(tuberia_senal[1]);
+    tuberia_senal[0] = tuberia_senal[1] = -1;
+    printf("%sServidor detenido.\n%s", AMARILLO, RESET);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include "trie.h"
+#include <stdio.h>
+
+/**
+ * @brief Largo maximo de una linea de consulta, incluyendo el '\0'.
+ *
+ * Las lineas mas largas se descartan completas y se responden con
+ * "ERROR linea demasiado larga".
+ */
+#define SERVIDOR_MAX_LINEA 256
+
+/**
+ * @brief Pausa en milisegundos antes de reintentar accept() sin descriptores.
+ *
+ * Si se agotan los descriptores o la memoria del sistema, el servidor
+ * espera este tiempo (o una senal de termino) en vez de reintentar de
+ * inmediato.
+ */
+#define SERVIDOR_PAUSA_ACEPTAR_MS 100
+
+/**
+ * @brief Responde una consulta del protocolo de lineas.
+ *
+ * Consultas: "search GEN", "max", "min" y "all". Cada gen se escribe como
+ * "GEN frecuencia posiciones..." en una linea; una busqueda sin resultados
+ * responde "GEN -1" y los errores "ERROR mensaje". Toda respuesta termina
+ * con una linea vacia.
+ *
+ * @param indice Indice cargado, solo se lee.
+ * @param linea Consulta sin salto de linea.
+ * @param destino Archivo donde se escribe la respuesta.
+ */
+void responder_consulta(const Indice* indice, const char* linea, FILE* destino);
+
+/**
+ * @brief Carga un indice una vez y lo sirve por un socket Unix.
+ *
+ * Cada cliente se atiende en su propio hilo. Como el indice no cambia
+ * despues de cargarse, los clientes lo leen a la vez sin bloqueos. Las
+ * consultas max, min y all no crean hilos: se reparten en el pool compartido
+ * de recorrido_paralelo, y el hilo del cliente recorre subarboles mientras
+ * espera, asi que con N clientes hay a lo mas N + procesadores - 1 hilos.
+ * El servidor termina con SIGINT o SIGTERM: corta la conexion de los
+ * clientes, espera a que sus hilos terminen y recien entonces libera el
+ * indice.
+ *
+ * @param ruta_socket Ruta del socket a crear.
+ * @param m Largo de los genes.
+ * @param nombre_archivo Archivo con la secuencia S.
+ * @param compactar 1 para construir el indice directamente en forma compacta.
+ * @return 0 al terminar, -1 si no se pudo cargar el indice o abrir el socket.
+ */
+int bio_serve(const char* ruta_socket, int m, const char* nombre_archivo, int compactar);
+
+#endif
@@ -1,4 +1,7 @@
 #include "trie.h"
+#include "trie_compacto.h"
+#include "recorrido_paralelo.h"
+#include "secuencia.h"
 #include "lista.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -23,19 +26,15 @@ Nodo* crear_nodo(void) {
 /**
  * @brief Obtiene el indice correspondiente a una base de ADN.
  *
- * Convierte los caracteres 'A', 'C', 'G', 'T' en indices 0-3.
+ * Convierte los caracteres 'A', 'C', 'G', 'T' en indices 0-3. Acepta
+ * minusculas igual que la lectura del archivo, para que las consultas
+ * encuentren los mismos genes.
  *
  * @param base Caracter de la base.
  * @return Indice 0-3 o -1 si es invalido.
  */
 int get_base_index(char base) {
-    switch (base) {
-        case 'A': return 0;
-        case 'C': return 1;
-        case 'G': return 2;
-        case 'T': return 3;
-        default: return -1;
-    }
+    return codigo_base((unsigned char)base);
 }
 
 /**
@@ -67,155 +66,179 @@ Nodo* generar_arbol_recursivo(int nivel_actual, int profundidad_max) {
  *
  * Reinicia cualquier estructura previa del programa.
  *
+ * @param indice Indice a inicializar.
  * @param m Largo de los genes.
  * @return Raiz del trie creado.
  */
-Nodo* bio_start(int m) {
+Nodo* bio_start(Indice* indice, int m) {
     if (m <= 0) {
         printf("%sError: El tamano del gen (m) debe ser mayor a 0.\n%s", ROJO, RESET);
         return NULL;
     }
-    if (TRIE_ROOT != NULL) {
-        bio_exit();
+    if (indice->raiz != NULL || indice->compacto != NULL) {
+        bio_exit(indice);
     }
-    GEN_SIZE = m;
-    TRIE_ROOT = generar_arbol_recursivo(0, m);
-    if (TRIE_ROOT != NULL) {
+    indice->gen_size = m;
+    indice->compactar = 0;
+    indice->raiz = generar_arbol_recursivo(0, m);
+    if (indice->raiz != NULL) {
         printf("%sArbol creado con tamano %d\n%s", AMARILLO, m, RESET);
     } else {
+        indice->gen_size = 0;
         printf("%sError al crear el arbol.\n%s", ROJO, RESET);
     }
-    return TRIE_ROOT;
+    return indice->raiz;
 }
 
 /**
- * @brief Inserta un gen en el trie.
+ * @brief Inserta el gen que empieza en una posicion de la secuencia empaquetada.
  *
- * @param gen Cadena del gen a insertar.
- * @param posicion Posicion en la secuencia original.
+ * @param indice Indice donde se inserta.
+ * @param secuencia Secuencia empaquetada.
+ * @param posicion Posicion inicial del gen; sus m bases deben ser validas.
  * @return 0 si se inserto correctamente, -1 si hubo error.
  */
-int insertar_gen_en_trie(const char* gen, int posicion) {
-    if (TRIE_ROOT == NULL || gen == NULL || (int)strlen(gen) != GEN_SIZE) {
+int insertar_empaquetado_en_trie(Indice* indice, const SecuenciaEmpaquetada* secuencia, long posicion) {
+    if (indice->raiz == NULL || posicion + indice->gen_size > secuencia->largo) {
         return -1;
     }
 
-    Nodo* actual = TRIE_ROOT;
-    int index;
-
-    for (int i = 0; i < GEN_SIZE; i++) {
-        index = get_base_index(gen[i]);
-        if (index == -1) {
-            return -1;
-        }
-        actual = actual->hijos[index];
+    Nodo* actual = indice->raiz;
+    for (int i = 0; i < indice->gen_size; i++) {
+        actual = actual->hijos[secuencia_base(secuencia, posicion + i)];
     }
-    actual->lista_posiciones = insertar_posicion(actual->lista_posiciones, posicion);
+    actual->lista_posiciones = insertar_posicion(actual->lista_posiciones, (int)posicion);
     return 0;
 }
 
 /**
  * @brief Lee una secuencia de ADN desde archivo y la carga en el trie.
  *
+ * La secuencia se valida y empaqueta a 2 bits por base antes de extraer
+ * los genes, y los genes con caracteres invalidos se omiten. Si el indice
+ * se inicio con bio_start_compacto(), los genes van directo al trie compacto.
+ *
+ * @param indice Indice donde se cargan los genes.
  * @param nombre_archivo Nombre del archivo a leer.
  * @return 0 si se leyo correctamente, -1 en caso de error.
  */
-int bio_read(const char* nombre_archivo) {
-    if (TRIE_ROOT == NULL) {
-        printf("%sError: El arbol no ha sido inicializado. Use 'bio start m' primero.\n%s", ROJO, RESET);
+int bio_read(Indice* indice, const char* nombre_archivo) {
+    if (indice->compacto != NULL) {
+        printf("%sError: El arbol esta compactado y es de solo lectura. Use 'bio start m' para reiniciar.\n%s", ROJO, RESET);
         return -1;
     }
-    FILE* file = fopen(nombre_archivo, "r");
-    if (file == NULL) {
-        perror("Error al abrir el archivo");
+    if (indice->raiz == NULL && !indice->compactar) {
+        printf("%sError: El arbol no ha sido inicializado. Use 'bio start m' primero.\n%s", ROJO, RESET);
         return -1;
     }
-
-    fseek(file, 0, SEEK_END);
-    long n_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    char* secuencia_S = (char*)malloc(n_size + 1);
+    SecuenciaEmpaquetada* secuencia_S = leer_secuencia(nombre_archivo);
     if (secuencia_S == NULL) {
-        perror("Error de asignacion de memoria para S");
-        fclose(file);
         return -1;
     }
 
-    size_t read_len = fread(secuencia_S, 1, n_size, file);
-    fclose(file);
-
-    int n = (int)read_len;
-    while (n > 0 && (secuencia_S[n - 1] == '\n' || secuencia_S[n - 1] == '\r' ||
-                     secuencia_S[n - 1] == ' '  || secuencia_S[n - 1] == '\t')) {
-        n--;
-    }
-    secuencia_S[n] = '\0';
-
-    int m = GEN_SIZE;
+    long n = secuencia_S->largo;
+    int m = indice->gen_size;
 
     if (n < m) {
         printf("%sLa secuencia S es mas corta que el tamano del gen m.\n%s", AMARILLO, RESET);
-        free(secuencia_S);
+        liberar_secuencia(secuencia_S);
         return -1;
     }
 
-    char* gen_buffer = (char*)malloc(m + 1);
-    if (gen_buffer == NULL) {
-        perror("Error de asignacion de memoria para gen_buffer");
-        free(secuencia_S);
-        return -1;
+    if (indice->compactar) {
+        indice->compacto = compactar_secuencia(secuencia_S, m);
+        liberar_secuencia(secuencia_S);
+        if (indice->compacto == NULL) {
+            printf("%sError al compactar el arbol.\n%s", ROJO, RESET);
+            return -1;
+        }
+        printf("%sSecuencia S leida desde el archivo\n%s", AMARILLO, RESET);
+        informar_compacto(indice->compacto);
+        return 0;
     }
-    gen_buffer[m] = '\0';
 
-    for (int i = 0; i <= n - m; i++) {
-        strncpy(gen_buffer, secuencia_S + i, m);
-        insertar_gen_en_trie(gen_buffer, i);
+    // Una ventana es valida si no contiene el ultimo caracter invalido visto
+    long ultimo_invalido = -1;
+    for (long j = 0; j < n; j++) {
+        if (secuencia_invalida(secuencia_S, j)) ultimo_invalido = j;
+        long i = j - m + 1;
+        if (i >= 0 && ultimo_invalido < i) {
+            insertar_empaquetado_en_trie(indice, secuencia_S, i);
+        }
     }
 
-    free(gen_buffer);
-    free(secuencia_S);
+    liberar_secuencia(secuencia_S);
     printf("%sSecuencia S leida desde el archivo\n%s", AMARILLO, RESET);
     return 0;
 }
 
+/**
+ * @brief Revisa el largo y los caracteres de un gen.
+ *
+ * @param indice Indice cargado.
+ * @param gen Gen a revisar.
+ * @return 0 si es valido, -1 si el largo es incorrecto, -2 si hay un caracter invalido.
+ */
+int validar_gen(const Indice* indice, const char* gen) {
+    int m = indice->gen_size;
+    if ((int)strlen(gen) != m) return -1;
+
+    for (int i = 0; i < m; i++) {
+        if (get_base_index(gen[i]) == -1) return -2;
+    }
+    return 0;
+}
+
+/**
+ * @brief Desciende por el trie hasta la hoja de un gen.
+ *
+ * @param indice Indice cargado.
+ * @param gen Gen ya validado.
+ * @return Lista de posiciones del gen o NULL si no aparece.
+ */
+ListaInt* indice_buscar(const Indice* indice, const char* gen) {
+    if (indice->compacto != NULL) {
+        return compacto_buscar(indice->compacto, gen);
+    }
+
+    Nodo* actual = indice->raiz;
+    for (int i = 0; i < indice->gen_size; i++) {
+        actual = actual->hijos[get_base_index(gen[i])];
+    }
+    return actual->lista_posiciones;
+}
+
 /**
  * @brief Busca un gen en el trie y muestra su frecuencia.
  *
+ * @param indice Indice cargado.
  * @param gen_G Gen a buscar.
  * @return Frecuencia encontrada o -1 si no existe.
  */
-int bio_search(const char* gen_G) {
-    if (TRIE_ROOT == NULL || GEN_SIZE == 0) {
+int bio_search(const Indice* indice, const char* gen_G) {
+    if ((indice->raiz == NULL && indice->compacto == NULL) || indice->gen_size == 0) {
         printf("%sError: El arbol no esta inicializado.\n%s", ROJO, RESET);
         return -1;
     }
-    
-    int m = GEN_SIZE;
-    if ((int)strlen(gen_G) != m) {
-        printf("%sError: El gen ingresado debe tener el largo %d.\n%s", ROJO, m, RESET);
+
+    int validez = validar_gen(indice, gen_G);
+    if (validez == -1) {
+        printf("%sError: El gen ingresado debe tener el largo %d.\n%s", ROJO, indice->gen_size, RESET);
         return -1;
     }
-
-    Nodo* actual = TRIE_ROOT;
-    int index;
-
-    for (int i = 0; i < m; i++) {
-        index = get_base_index(gen_G[i]);
-        if (index == -1) {
-            printf("%sNo se encontro el gen %s debido a caracter invalido.\n%s", ROJO, gen_G, RESET);
-            return -1;
-        }
-        actual = actual->hijos[index];
+    if (validez == -2) {
+        printf("%sNo se encontro el gen %s debido a caracter invalido.\n%s", ROJO, gen_G, RESET);
+        return -1;
     }
-    
-    int frecuencia = contar_posiciones(actual->lista_posiciones);
+
+    ListaInt* lista = indice_buscar(indice, gen_G);
+    int frecuencia = contar_posiciones(lista);
     if (frecuencia == 0) {
         printf("El gen %s no se encontro. Frecuencia: %s-1%s\n", gen_G, ROJO, RESET);
         return -1;
     }
     printf("%sEl gen %s esta %d veces en las posiciones:%s", AMARILLO, gen_G, frecuencia, RESET);
-    imprimir_posiciones(actual->lista_posiciones);
+    imprimir_posiciones(lista);
     printf("\n");
     
     return frecuencia;
@@ -227,13 +250,14 @@ int bio_search(const char* gen_G) {
  * @param nodo Nodo actual.
  * @param buffer Cadena para construir el gen.
  * @param nivel Nivel actual.
+ * @param m Largo de los genes.
  * @param mode 1 = max, 0 = min.
  * @param extremum Valor a actualizar.
  */
-void recorrido_extremos(Nodo* nodo, char* buffer, int nivel, int mode, int* extremum) {
+void recorrido_extremos(Nodo* nodo, char* buffer, int nivel, int m, int mode, int* extremum) {
     if (nodo == NULL) return;
 
-    if (nivel == GEN_SIZE) {
+    if (nivel == m) {
         int frecuencia = contar_posiciones(nodo->lista_posiciones);
         if (mode == 1) {
             if (frecuencia > *extremum) *extremum = frecuencia;
@@ -246,7 +270,7 @@ void recorrido_extremos(Nodo* nodo, char* buffer, int nivel, int mode, int* extr
     const char bases[] = {'A', 'C', 'G', 'T'};
     for (int i = 0; i < 4; i++) {
         buffer[nivel] = bases[i];
-        recorrido_extremos(nodo->hijos[i], buffer, nivel + 1, mode, extremum);
+        recorrido_extremos(nodo->hijos[i], buffer, nivel + 1, m, mode, extremum);
     }
 }
 
@@ -256,18 +280,20 @@ void recorrido_extremos(Nodo* nodo, char* buffer, int nivel, int mode, int* extr
  * @param nodo Nodo actual.
  * @param buffer Cadena con el gen construido.
  * @param nivel Nivel actual.
- * @param target_freq Frecuencia objetivo.
+ * @param m Largo de los genes.
+ * @param target_freq Frecuencia objetivo, o 0 para imprimir todos.
+ * @param salida Buffer donde se escriben los genes.
  */
-void imprimir_recorrido(Nodo* nodo, char* buffer, int nivel, int target_freq) {
+void imprimir_recorrido(Nodo* nodo, char* buffer, int nivel, int m, int target_freq, Salida* salida) {
     if (nodo == NULL) return;
 
-    if (nivel == GEN_SIZE) {
+    if (nivel == m) {
         int frecuencia = contar_posiciones(nodo->lista_posiciones);
-        if (frecuencia == target_freq && frecuencia > 0) {
-            buffer[GEN_SIZE] = '\0';
-            printf("%s %d", buffer, frecuencia);
-            imprimir_posiciones(nodo->lista_posiciones);
-            printf("\n");
+        if (frecuencia > 0 && (target_freq == 0 || frecuencia == target_freq)) {
+            buffer[m] = '\0';
+            salida_printf(salida, "%s %d", buffer, frecuencia);
+            escribir_posiciones(nodo->lista_posiciones, salida);
+            salida_printf(salida, "\n");
         }
         return;
     }
@@ -275,95 +301,72 @@ void imprimir_recorrido(Nodo* nodo, char* buffer, int nivel, int target_freq) {
     const char bases[] = {'A', 'C', 'G', 'T'};
     for (int i = 0; i < 4; i++) {
         buffer[nivel] = bases[i];
-        imprimir_recorrido(nodo->hijos[i], buffer, nivel + 1, target_freq);
+        imprimir_recorrido(nodo->hijos[i], buffer, nivel + 1, m, target_freq, salida);
     }
 }
 
 /**
  * @brief Muestra el gen con mayor frecuencia.
+ *
+ * @param indice Indice cargado.
  */
-void bio_max() {
-    if (TRIE_ROOT == NULL || GEN_SIZE == 0) {
+void bio_max(const Indice* indice) {
+    if ((indice->raiz == NULL && indice->compacto == NULL) || indice->gen_size == 0) {
         printf("%sError: Arbol no cargado.\n%s", ROJO, RESET);
         return;
     }
 
-    char* gen_buffer = (char*)malloc(GEN_SIZE + 1);
-    if (gen_buffer == NULL) { perror("Error de asignacion"); return; }
-
-    int max_freq = 0;
-    recorrido_extremos(TRIE_ROOT, gen_buffer, 0, 1, &max_freq);
+    int max_freq = paralelo_extremo(indice, 1);
+    if (max_freq == -1) return;
 
     if (max_freq == 0) {
         printf("%sNo hay genes presentes.\n%s", AMARILLO, RESET);
-        free(gen_buffer);
         return;
     }
 
-    imprimir_recorrido(TRIE_ROOT, gen_buffer, 0, max_freq);
-    free(gen_buffer);
+    if (paralelo_imprimir(indice, max_freq, stdout) == -1) {
+        printf("%sError: No se pudo generar la salida completa.\n%s", ROJO, RESET);
+    }
 }
 
 /**
  * @brief Muestra el gen con menor frecuencia.
+ *
+ * @param indice Indice cargado.
  */
-void bio_min() {
-    if (TRIE_ROOT == NULL || GEN_SIZE == 0) {
+void bio_min(const Indice* indice) {
+    if ((indice->raiz == NULL && indice->compacto == NULL) || indice->gen_size == 0) {
         printf("%sError: Arbol no cargado.\n%s", ROJO, RESET);
         return;
     }
 
-    char* gen_buffer = (char*)malloc(GEN_SIZE + 1);
-    if (gen_buffer == NULL) { perror("Error de asignacion"); return; }
-
-    int min_freq = INT_MAX;
-    recorrido_extremos(TRIE_ROOT, gen_buffer, 0, 0, &min_freq);
+    int min_freq = paralelo_extremo(indice, 0);
+    if (min_freq == -1) return;
 
     if (min_freq == INT_MAX) {
         printf("%sNo hay genes presentes.\n%s", AMARILLO, RESET);
-        free(gen_buffer);
         return;
     }
 
-    imprimir_recorrido(TRIE_ROOT, gen_buffer, 0, min_freq);
-    free(gen_buffer);
+    if (paralelo_imprimir(indice, min_freq, stdout) == -1) {
+        printf("%sError: No se pudo generar la salida completa.\n%s", ROJO, RESET);
+    }
 }
 
 /**
  * @brief Muestra todos los genes con frecuencia mayor que 0.
+ *
+ * @param indice Indice cargado.
  */
-void bio_all() {
-    if (TRIE_ROOT == NULL || GEN_SIZE == 0) {
+void bio_all(const Indice* indice) {
+    if ((indice->raiz == NULL && indice->compacto == NULL) || indice->gen_size == 0) {
         printf("%sError: Arbol no cargado.\n%s", ROJO, RESET);
         return;
     }
 
-    char* gen_buffer = (char*)malloc(GEN_SIZE + 1);
-    if (gen_buffer == NULL) { perror("Error de asignacion"); return; }
-
-    void bio_all_recursivo(Nodo* nodo, char* buffer, int nivel) {
-        if (nodo == NULL) return;
-
-        if (nivel == GEN_SIZE) {
-            int frecuencia = contar_posiciones(nodo->lista_posiciones);
-            if (frecuencia > 0) {
-                buffer[GEN_SIZE] = '\0';
-                printf("%s %d", buffer, frecuencia);
-                imprimir_posiciones(nodo->lista_posiciones);
-                printf("\n");
-            }
-            return;
-        }
-
-        const char bases[] = {'A', 'C', 'G', 'T'};
-        for (int i = 0; i < 4; i++) {
-            buffer[nivel] = bases[i];
-            bio_all_recursivo(nodo->hijos[i], buffer, nivel + 1);
-        }
+    if (paralelo_imprimir(indice, 0, stdout) == -1) {
+        printf("%sError: No se pudo generar la salida completa.\n%s", ROJO, RESET);
     }
-
-    bio_all_recursivo(TRIE_ROOT, gen_buffer, 0);
-    free(gen_buffer);
 }
 
 /**
@@ -382,12 +385,26 @@ void liberar_arbol(Nodo* nodo) {
 }
 
 /**
- * @brief Libera memoria global y cierra el programa.
+ * @brief Libera el trie de un indice sin imprimir mensajes.
+ *
+ * @param indice Indice a liberar.
+ */
+void liberar_indice(Indice* indice) {
+    liberar_arbol(indice->raiz);
+    indice->raiz = NULL;
+    liberar_compacto(indice->compacto);
+    indice->compacto = NULL;
+    indice->gen_size = 0;
+    indice->compactar = 0;
+}
+
+/**
+ * @brief Libera la memoria del indice y cierra el programa.
+ *
+ * @param indice Indice a liberar.
  */
-void bio_exit() {
-    liberar_arbol(TRIE_ROOT);
-    TRIE_ROOT = NULL;
-    GEN_SIZE = 0;
+void bio_exit(Indice* indice) {
+    liberar_indice(indice);
     printf("%sLimpiando cache y saliendo del programa...\n%s", AMARILLO, RESET);
 }
 
@@ -397,10 +414,13 @@ void bio_exit() {
 void help() {
     printf("%sCOMANDOS DISPONIBLES:\n%s", VERDE_CLARO, RESET);
     printf("%sbio start m%s: crea un arbol 4-ario\n", AZUL, RESET);
+    printf("%sbio start m compact%s: crea un indice compacto de solo lectura sin el arbol completo (m grandes)\n", AZUL, RESET);
     printf("%sbio read archivo.txt%s: lee la secuencia S\n", AZUL, RESET);
     printf("%sbio search XX%s: busca un gen\n", AZUL, RESET);
     printf("%sbio max%s: muestra el gen mas repetido\n", AZUL, RESET);
     printf("%sbio min%s: muestra el gen menos repetido\n", AZUL, RESET);
     printf("%sbio all%s: lista todos los genes frecuentes\n", AZUL, RESET);
+    printf("%sbio compact%s: compacta el arbol para consultas de solo lectura\n", AZUL, RESET);
     printf("%sbio exit%s: libera memoria y termina\n", AZUL, RESET);
+    printf("%s./bio serve socket m archivo.txt [compact]%s: carga el indice una vez y responde consultas por un socket Unix\n", AZUL, RESET);
 }
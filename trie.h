@@ -23,19 +23,21 @@ typedef struct Nodo {
     ListaInt* lista_posiciones;   /**< Lista de posiciones del gen (solo en hojas) */
 } Nodo;
 
-/** 
- * @brief Largo del gen utilizado por el trie. 
- *
- * Debe ser definido con bio_start().
- */
-extern int GEN_SIZE;
+struct TrieCompacto;
 
-/** 
- * @brief Puntero a la raiz del trie principal. 
+/**
+ * @brief Indice de genes cargado desde una secuencia.
  *
- * Se asigna en bio_start().
+ * Agrupa el trie y el largo de sus genes para que cada indice se maneje por
+ * separado. Una vez cargado, las consultas solo lo leen, por lo que varios
+ * hilos pueden consultarlo a la vez sin bloqueos.
  */
-extern Nodo* TRIE_ROOT;
+typedef struct Indice {
+    Nodo* raiz;                      /**< Raiz del trie de punteros, o NULL si esta compactado */
+    struct TrieCompacto* compacto;   /**< Trie compactado de solo lectura, o NULL */
+    int gen_size;                    /**< Largo de los genes; se define con bio_start() */
+    int compactar;                   /**< 1 si bio_read() construye directamente el trie compacto */
+} Indice;
 
 /**
  * @brief Crea y retorna un nodo del trie.
@@ -45,10 +47,11 @@ Nodo* crear_nodo(void);
 
 /**
  * @brief Inicializa el trie creando un arbol 4-ario de profundidad m.
+ * @param indice Indice a inicializar; se libera su contenido previo.
  * @param m Largo del gen.
  * @return Puntero a la raiz del trie.
  */
-Nodo* bio_start(int m);
+Nodo* bio_start(Indice* indice, int m);
 
 /**
  * @brief Imprime los comandos disponibles del programa.
@@ -57,47 +60,93 @@ void help();
 
 /**
  * @brief Convierte una base ADN (A,C,G,T) en su indice numerico.
- * @param base Caracter 'A', 'C', 'G' o 'T'.
+ * @param base Caracter 'A', 'C', 'G' o 'T', en mayuscula o minuscula.
  * @return Indice entre 0 y 3, o -1 si el caracter es invalido.
  */
 int get_base_index(char base);
 
+struct SecuenciaEmpaquetada;
+
 /**
- * @brief Inserta un gen en el trie y registra la posicion donde aparece.
- * @param gen Secuencia de largo GEN_SIZE.
- * @param posicion Posicion inicial dentro de la secuencia S.
+ * @brief Inserta el gen que empieza en una posicion de la secuencia empaquetada.
+ * @param indice Indice donde se inserta.
+ * @param secuencia Secuencia validada y empaquetada a 2 bits por base.
+ * @param posicion Posicion inicial del gen; sus m bases deben ser validas.
  * @return 0 si se inserta correctamente, -1 si ocurre un error.
  */
-int insertar_gen_en_trie(const char* gen, int posicion);
+int insertar_empaquetado_en_trie(Indice* indice, const struct SecuenciaEmpaquetada* secuencia, long posicion);
 
 /**
  * @brief Lee un archivo de ADN completo y carga todos los genes en el trie.
+ * @param indice Indice donde se cargan los genes.
  * @param nombre_archivo Nombre del archivo a leer.
  * @return 0 si se carga correctamente, -1 en caso de error.
  */
-int bio_read(const char* nombre_archivo);
+int bio_read(Indice* indice, const char* nombre_archivo);
+
+/**
+ * @brief Revisa que un gen se pueda buscar en un indice.
+ * @param indice Indice cargado.
+ * @param gen Secuencia a revisar.
+ * @return 0 si es valido, -1 si su largo no es el del indice, -2 si tiene un caracter invalido.
+ */
+int validar_gen(const Indice* indice, const char* gen);
+
+/**
+ * @brief Obtiene las posiciones de un gen ya validado.
+ * @param indice Indice cargado.
+ * @param gen Secuencia valida segun validar_gen().
+ * @return Lista de posiciones, o NULL si el gen no aparece.
+ */
+ListaInt* indice_buscar(const Indice* indice, const char* gen);
 
 /**
  * @brief Busca un gen dentro del trie.
+ * @param indice Indice cargado.
  * @param gen_G Secuencia a buscar.
  * @return Frecuencia del gen o -1 si no se encuentra o es invalido.
  */
-int bio_search(const char* gen_G);
+int bio_search(const Indice* indice, const char* gen_G);
+
+/**
+ * @brief Recorre un subarbol para obtener la frecuencia maxima o minima.
+ * @param nodo Nodo raiz del subarbol.
+ * @param buffer Cadena para construir el gen.
+ * @param nivel Nivel del nodo.
+ * @param m Largo de los genes.
+ * @param mode 1 = max, 0 = min.
+ * @param extremum Valor a actualizar.
+ */
+void recorrido_extremos(Nodo* nodo, char* buffer, int nivel, int m, int mode, int* extremum);
+
+/**
+ * @brief Escribe los genes de un subarbol con la frecuencia indicada.
+ * @param nodo Nodo raiz del subarbol.
+ * @param buffer Cadena con el prefijo del gen.
+ * @param nivel Nivel del nodo.
+ * @param m Largo de los genes.
+ * @param target_freq Frecuencia objetivo, o 0 para todos los genes presentes.
+ * @param salida Buffer donde se escriben los genes.
+ */
+void imprimir_recorrido(Nodo* nodo, char* buffer, int nivel, int m, int target_freq, Salida* salida);
 
 /**
  * @brief Muestra el gen con mayor frecuencia dentro del trie.
+ * @param indice Indice cargado.
  */
-void bio_max();
+void bio_max(const Indice* indice);
 
 /**
  * @brief Muestra el gen con menor frecuencia dentro del trie.
+ * @param indice Indice cargado.
  */
-void bio_min();
+void bio_min(const Indice* indice);
 
 /**
  * @brief Imprime todos los genes con frecuencia mayor a 0.
+ * @param indice Indice cargado.
  */
-void bio_all();
+void bio_all(const Indice* indice);
 
 /**
  * @brief Libera recursivamente todos los nodos del trie.
@@ -105,9 +154,16 @@ void bio_all();
  */
 void liberar_arbol(Nodo* nodo);
 
+/**
+ * @brief Libera el trie de un indice y lo deja vacio.
+ * @param indice Indice a liberar.
+ */
+void liberar_indice(Indice* indice);
+
 /**
  * @brief Libera toda la memoria del programa y reinicia el estado.
+ * @param indice Indice a liberar.
  */
-void bio_exit();
+void bio_exit(Indice* indice);
 
 #endif
@@ -0,0 +1,492 @@
+#include "trie_compacto.h"
+#include "trie.h"
+#include "lista.h"
+#include "secuencia.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Arreglos dinamicos con las hojas no vacias del trie de punteros.
+ */
+typedef struct HojasRecolectadas {
+    uint64_t* codigos;   /**< Gen codificado con 2 bits por base */
+    ListaInt** listas;   /**< Lista de posiciones de cada gen */
+    long cantidad;       /**< Hojas guardadas */
+    long capacidad;      /**< Espacio reservado */
+} HojasRecolectadas;
+
+/**
+ * @brief Gen de una ventana de la secuencia junto con su posicion.
+ */
+typedef struct Ocurrencia {
+    uint64_t codigo;   /**< Gen codificado con 2 bits por base */
+    int pos;           /**< Posicion inicial en la secuencia S */
+} Ocurrencia;
+
+/**
+ * @brief Recorre el trie de punteros guardando las hojas con posiciones.
+ *
+ * Las hojas se visitan en orden lexicografico, por lo que los codigos
+ * quedan ordenados de menor a mayor.
+ *
+ * @param nodo Nodo actual.
+ * @param codigo Prefijo codificado hasta el nivel actual.
+ * @param nivel Nivel actual.
+ * @param m Largo de los genes.
+ * @param hojas Arreglos donde se agregan las hojas.
+ * @return 0 si se recorrio correctamente, -1 si falla la asignacion.
+ */
+int recolectar_hojas(Nodo* nodo, uint64_t codigo, int nivel, int m, HojasRecolectadas* hojas) {
+    if (nodo == NULL) return 0;
+
+    if (nivel == m) {
+        if (nodo->lista_posiciones == NULL) return 0;
+        if (hojas->cantidad == hojas->capacidad) {
+            long nueva = hojas->capacidad > 0 ? hojas->capacidad * 2 : 64;
+            uint64_t* codigos = (uint64_t*)realloc(hojas->codigos, nueva * sizeof(uint64_t));
+            if (codigos == NULL) return -1;
+            hojas->codigos = codigos;
+            ListaInt** listas = (ListaInt**)realloc(hojas->listas, nueva * sizeof(ListaInt*));
+            if (listas == NULL) return -1;
+            hojas->listas = listas;
+            hojas->capacidad = nueva;
+        }
+        hojas->codigos[hojas->cantidad] = codigo;
+        hojas->listas[hojas->cantidad] = nodo->lista_posiciones;
+        hojas->cantidad++;
+        return 0;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        if (recolectar_hojas(nodo->hijos[i], (codigo << 2) | (uint64_t)i, nivel + 1, m, hojas) == -1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Desvincula las listas de posiciones de los nodos del trie.
+ *
+ * Se usa al terminar compactar_trie(), cuando las listas ya fueron
+ * traspasadas al trie compacto.
+ *
+ * @param nodo Nodo raiz del subarbol.
+ */
+void quitar_listas(Nodo* nodo) {
+    if (nodo == NULL) return;
+
+    for (int i = 0; i < 4; i++) {
+        quitar_listas(nodo->hijos[i]);
+    }
+    nodo->lista_posiciones = NULL;
+}
+
+/**
+ * @brief Cuenta los unos del bitmap antes de una posicion.
+ *
+ * @param tc Trie compacto.
+ * @param bit Posicion dentro del bitmap.
+ * @return Cantidad de bits en 1 en el rango [0, bit).
+ */
+long compacto_rank(const TrieCompacto* tc, long bit) {
+    long palabra = bit >> 6;
+    int desplazamiento = (int)(bit & 63);
+    long rank = tc->rank_palabras[palabra];
+    if (desplazamiento > 0) {
+        rank += __builtin_popcountll(tc->bits[palabra] << (64 - desplazamiento));
+    }
+    return rank;
+}
+
+/**
+ * @brief Indica si un bit del bitmap esta en 1.
+ *
+ * @param tc Trie compacto.
+ * @param bit Posicion dentro del bitmap.
+ * @return 1 si el bit esta encendido, 0 si no.
+ */
+int compacto_bit(const TrieCompacto* tc, long bit) {
+    return (int)((tc->bits[bit >> 6] >> (bit & 63)) & 1);
+}
+
+/**
+ * @brief Construye el bitmap LOUDS a partir de las hojas ordenadas.
+ *
+ * Para cada nivel, los prefijos distintos son los nodos de ese nivel en
+ * orden, y las bases siguientes marcan sus hijos. Si tiene exito, el
+ * arreglo de listas pasa a pertenecer al trie compacto; si falla, no se
+ * modifica.
+ *
+ * @param codigos Genes distintos codificados, de menor a mayor.
+ * @param listas Lista de posiciones de cada gen.
+ * @param cantidad Cantidad de genes.
+ * @param m Largo de los genes.
+ * @return Trie compacto o NULL si falla la asignacion.
+ */
+TrieCompacto* construir_compacto(const uint64_t* codigos, ListaInt** listas, long cantidad, int m) {
+    TrieCompacto* tc = (TrieCompacto*)calloc(1, sizeof(TrieCompacto));
+    if (tc == NULL) {
+        perror("Error de asignacion de memoria para TrieCompacto");
+        return NULL;
+    }
+    tc->profundidad = m;
+    tc->num_hojas = cantidad;
+
+    // Nodos internos: la raiz mas los prefijos distintos de largo 1 a m-1
+    tc->num_internos = 1;
+    for (int nivel = 1; nivel < m; nivel++) {
+        int corrimiento = 2 * (m - nivel);
+        for (long k = 0; k < cantidad; k++) {
+            if (k == 0 || (codigos[k] >> corrimiento) != (codigos[k - 1] >> corrimiento)) {
+                tc->num_internos++;
+            }
+        }
+    }
+
+    long num_bits = 4 * tc->num_internos;
+    tc->num_palabras = (num_bits + 63) / 64;
+    tc->bits = (uint64_t*)calloc(tc->num_palabras, sizeof(uint64_t));
+    tc->rank_palabras = (uint32_t*)calloc(tc->num_palabras, sizeof(uint32_t));
+    if (tc->bits == NULL || tc->rank_palabras == NULL) {
+        perror("Error de asignacion de memoria para el bitmap");
+        free(tc->bits);
+        free(tc->rank_palabras);
+        free(tc);
+        return NULL;
+    }
+
+    long nodo = -1;
+    for (int nivel = 0; nivel < m; nivel++) {
+        int corrimiento = 2 * (m - nivel);
+        for (long k = 0; k < cantidad; k++) {
+            uint64_t prefijo = corrimiento < 64 ? codigos[k] >> corrimiento : 0;
+            uint64_t anterior = (k > 0 && corrimiento < 64) ? codigos[k - 1] >> corrimiento : 0;
+            if (k == 0 || prefijo != anterior) nodo++;
+            long bit = 4 * nodo + (long)((codigos[k] >> (corrimiento - 2)) & 3);
+            tc->bits[bit >> 6] |= (uint64_t)1 << (bit & 63);
+        }
+    }
+
+    uint32_t acumulado = 0;
+    for (long p = 0; p < tc->num_palabras; p++) {
+        tc->rank_palabras[p] = acumulado;
+        acumulado += (uint32_t)__builtin_popcountll(tc->bits[p]);
+    }
+
+    tc->hojas = listas;
+    return tc;
+}
+
+/**
+ * @brief Construye el trie compacto a partir del trie de punteros.
+ *
+ * Si la construccion termina bien, las listas quedan solo en el trie
+ * compacto; si falla, el trie de punteros no se modifica.
+ *
+ * @param raiz Raiz del trie de punteros.
+ * @param m Largo de los genes.
+ * @return Trie compacto o NULL si falla la asignacion.
+ */
+TrieCompacto* compactar_trie(Nodo* raiz, int m) {
+    if (raiz == NULL || m <= 0 || m > COMPACTO_MAX_GEN) return NULL;
+
+    HojasRecolectadas hojas = {NULL, NULL, 0, 0};
+    if (recolectar_hojas(raiz, 0, 0, m, &hojas) == -1) {
+        perror("Error de asignacion de memoria para las hojas");
+        free(hojas.codigos);
+        free(hojas.listas);
+        return NULL;
+    }
+
+    TrieCompacto* tc = construir_compacto(hojas.codigos, hojas.listas, hojas.cantidad, m);
+    free(hojas.codigos);
+    if (tc == NULL) {
+        free(hojas.listas);
+        return NULL;
+    }
+
+    // Las listas pasan al trie compacto y se quitan de los nodos originales
+    quitar_listas(raiz);
+    return tc;
+}
+
+/**
+ * @brief Compara dos ocurrencias por gen y luego por posicion.
+ *
+ * @param a Primera ocurrencia.
+ * @param b Segunda ocurrencia.
+ * @return Negativo, cero o positivo segun el orden.
+ */
+int comparar_ocurrencias(const void* a, const void* b) {
+    const Ocurrencia* x = (const Ocurrencia*)a;
+    const Ocurrencia* y = (const Ocurrencia*)b;
+    if (x->codigo != y->codigo) return x->codigo < y->codigo ? -1 : 1;
+    return (x->pos > y->pos) - (x->pos < y->pos);
+}
+
+/**
+ * @brief Construye el trie compacto directamente desde la secuencia empaquetada.
+ *
+ * Cada ventana valida de m bases ya es un codigo de 2 bits por base, asi
+ * que basta ordenar los codigos y agrupar sus posiciones para tener las
+ * hojas en orden lexicografico, sin crear el arbol de punteros. La memoria
+ * extra es proporcional al largo de S y no a 4^m.
+ *
+ * @param secuencia Secuencia validada y empaquetada.
+ * @param m Largo de los genes.
+ * @return Trie compacto o NULL si falla la asignacion.
+ */
+TrieCompacto* compactar_secuencia(const SecuenciaEmpaquetada* secuencia, int m) {
+    long n = secuencia->largo;
+    if (m <= 0 || m > COMPACTO_MAX_GEN || n < m) return NULL;
+
+    Ocurrencia* ocurrencias = (Ocurrencia*)malloc((n - m + 1) * sizeof(Ocurrencia));
+    if (ocurrencias == NULL) {
+        perror("Error de asignacion de memoria para las ocurrencias");
+        return NULL;
+    }
+
+    // El codigo de cada ventana se arma desplazando el de la anterior
+    uint64_t mascara = 2 * m >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << (2 * m)) - 1;
+    uint64_t codigo = 0;
+    long ultimo_invalido = -1;
+    long cantidad = 0;
+    for (long j = 0; j < n; j++) {
+        if (secuencia_invalida(secuencia, j)) ultimo_invalido = j;
+        codigo = ((codigo << 2) | (uint64_t)secuencia_base(secuencia, j)) & mascara;
+        long i = j - m + 1;
+        if (i >= 0 && ultimo_invalido < i) {
+            ocurrencias[cantidad].codigo = codigo;
+            ocurrencias[cantidad].pos = (int)i;
+            cantidad++;
+        }
+    }
+    qsort(ocurrencias, cantidad, sizeof(Ocurrencia), comparar_ocurrencias);
+
+    long distintos = 0;
+    for (long k = 0; k < cantidad; k++) {
+        if (k == 0 || ocurrencias[k].codigo != ocurrencias[k - 1].codigo) distintos++;
+    }
+
+    uint64_t* codigos = NULL;
+    ListaInt** listas = NULL;
+    if (distintos > 0) {
+        codigos = (uint64_t*)malloc(distintos * sizeof(uint64_t));
+        listas = (ListaInt**)calloc(distintos, sizeof(ListaInt*));
+        if (codigos == NULL || listas == NULL) {
+            perror("Error de asignacion de memoria para las hojas");
+            free(codigos);
+            free(listas);
+            free(ocurrencias);
+            return NULL;
+        }
+    }
+
+    // Cada grupo se enlaza desde el final para dejar las posiciones en orden
+    long hoja = distintos;
+    for (long k = cantidad - 1; k >= 0; k--) {
+        if (k == cantidad - 1 || ocurrencias[k].codigo != ocurrencias[k + 1].codigo) {
+            hoja--;
+            codigos[hoja] = ocurrencias[k].codigo;
+        }
+        ListaInt* nodo = crear_nodo_lista(ocurrencias[k].pos);
+        if (nodo == NULL) {
+            for (long h = 0; h < distintos; h++) liberar_lista(listas[h]);
+            free(codigos);
+            free(listas);
+            free(ocurrencias);
+            return NULL;
+        }
+        nodo->siguiente = listas[hoja];
+        listas[hoja] = nodo;
+    }
+    free(ocurrencias);
+
+    TrieCompacto* tc = construir_compacto(codigos, listas, distintos, m);
+    free(codigos);
+    if (tc == NULL) {
+        for (long h = 0; h < distintos; h++) liberar_lista(listas[h]);
+        free(listas);
+    }
+    return tc;
+}
+
+/**
+ * @brief Busca un gen descendiendo por el bitmap.
+ *
+ * @param tc Trie compacto.
+ * @param gen Gen a buscar, ya validado.
+ * @return Lista de posiciones o NULL si el gen no aparece.
+ */
+ListaInt* compacto_buscar(const TrieCompacto* tc, const char* gen) {
+    long nodo = 0;
+    for (int i = 0; i < tc->profundidad; i++) {
+        long bit = 4 * nodo + get_base_index(gen[i]);
+        if (!compacto_bit(tc, bit)) return NULL;
+        nodo = compacto_rank(tc, bit) + 1;
+    }
+    return tc->hojas[nodo - tc->num_internos];
+}
+
+/**
+ * @brief Recorre un subarbol para obtener la frecuencia maxima o minima.
+ *
+ * @param tc Trie compacto.
+ * @param nodo Nodo actual.
+ * @param nivel Nivel actual.
+ * @param mode 1 = max, 0 = min.
+ * @param extremum Valor a actualizar.
+ */
+void compacto_recorrido_extremos(const TrieCompacto* tc, long nodo, int nivel, int mode, int* extremum) {
+    if (nivel == tc->profundidad) {
+        int frecuencia = contar_posiciones(tc->hojas[nodo - tc->num_internos]);
+        if (mode == 1) {
+            if (frecuencia > *extremum) *extremum = frecuencia;
+        } else {
+            if (frecuencia > 0 && frecuencia < *extremum) *extremum = frecuencia;
+        }
+        return;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        long bit = 4 * nodo + i;
+        if (!compacto_bit(tc, bit)) continue;
+        compacto_recorrido_extremos(tc, compacto_rank(tc, bit) + 1, nivel + 1, mode, extremum);
+    }
+}
+
+/**
+ * @brief Escribe los genes de un subarbol del trie compacto.
+ *
+ * @param tc Trie compacto.
+ * @param nodo Nodo actual.
+ * @param buffer Cadena con el gen construido.
+ * @param nivel Nivel actual.
+ * @param target_freq Frecuencia objetivo, o 0 para imprimir todos.
+ * @param salida Buffer donde se escriben los genes.
+ */
+void compacto_imprimir_recorrido(const TrieCompacto* tc, long nodo, char* buffer, int nivel, int target_freq, Salida* salida) {
+    if (nivel == tc->profundidad) {
+        ListaInt* lista = tc->hojas[nodo - tc->num_internos];
+        int frecuencia = contar_posiciones(lista);
+        if (target_freq == 0 || frecuencia == target_freq) {
+            buffer[tc->profundidad] = '\0';
+            salida_printf(salida, "%s %d", buffer, frecuencia);
+            escribir_posiciones(lista, salida);
+            salida_printf(salida, "\n");
+        }
+        return;
+    }
+
+    const char bases[] = {'A', 'C', 'G', 'T'};
+    for (int i = 0; i < 4; i++) {
+        long bit = 4 * nodo + i;
+        if (!compacto_bit(tc, bit)) continue;
+        buffer[nivel] = bases[i];
+        compacto_imprimir_recorrido(tc, compacto_rank(tc, bit) + 1, buffer, nivel + 1, target_freq, salida);
+    }
+}
+
+/**
+ * @brief Calcula la memoria usada por el trie compacto, sin las listas.
+ *
+ * @param tc Trie compacto.
+ * @return Bytes ocupados.
+ */
+size_t compacto_memoria(const TrieCompacto* tc) {
+    return sizeof(TrieCompacto)
+         + tc->num_palabras * (sizeof(uint64_t) + sizeof(uint32_t))
+         + tc->num_hojas * sizeof(ListaInt*);
+}
+
+/**
+ * @brief Libera el bitmap, las hojas y sus listas de posiciones.
+ *
+ * @param tc Trie compacto.
+ */
+void liberar_compacto(TrieCompacto* tc) {
+    if (tc == NULL) return;
+
+    for (long k = 0; k < tc->num_hojas; k++) {
+        liberar_lista(tc->hojas[k]);
+    }
+    free(tc->hojas);
+    free(tc->bits);
+    free(tc->rank_palabras);
+    free(tc);
+}
+
+/**
+ * @brief Muestra el tamano del trie compacto.
+ *
+ * @param tc Trie compacto.
+ */
+void informar_compacto(const TrieCompacto* tc) {
+    long num_nodos = tc->num_internos + tc->num_hojas;
+    size_t bytes_bitmap = tc->num_palabras * (sizeof(uint64_t) + sizeof(uint32_t));
+    printf("%sArbol compactado: %ld nodos, bitmap de %zu bytes (%.2f bits por nodo), %zu bytes en total\n%s",
+           AMARILLO, num_nodos, bytes_bitmap, (double)(bytes_bitmap * 8) / (double)num_nodos,
+           compacto_memoria(tc), RESET);
+}
+
+/**
+ * @brief Prepara un indice que se construye compacto al leer la secuencia.
+ *
+ * No crea el arbol de punteros de 4^m nodos: bio_read() arma el trie
+ * compacto directamente con compactar_secuencia(). Conviene para m grandes,
+ * donde el arbol completo no cabe en memoria.
+ *
+ * @param indice Indice a inicializar.
+ * @param m Largo de los genes.
+ * @return 0 si se inicializo, -1 si m no es valido.
+ */
+int bio_start_compacto(Indice* indice, int m) {
+    if (m <= 0 || m > COMPACTO_MAX_GEN) {
+        printf("%sError: El trie compacto admite genes de largo entre 1 y %d.\n%s", ROJO, COMPACTO_MAX_GEN, RESET);
+        return -1;
+    }
+    if (indice->raiz != NULL || indice->compacto != NULL) {
+        bio_exit(indice);
+    }
+    indice->gen_size = m;
+    indice->compactar = 1;
+    printf("%sIndice compacto creado con tamano %d; se construye al leer la secuencia\n%s", AMARILLO, m, RESET);
+    return 0;
+}
+
+/**
+ * @brief Compacta el trie cargado y libera el arbol de punteros.
+ *
+ * Despues de compactar, el indice es de solo lectura: search, max, min y
+ * all usan el bitmap, y read queda deshabilitado hasta el siguiente start.
+ * Como parte del trie de punteros, su memoria maxima sigue siendo la del
+ * arbol completo; para m grandes se usa "start m compact".
+ *
+ * @param indice Indice cargado.
+ */
+void bio_compact(Indice* indice) {
+    if (indice->compacto != NULL) {
+        printf("%sError: El arbol ya esta compactado.\n%s", ROJO, RESET);
+        return;
+    }
+    if (indice->raiz == NULL || indice->gen_size == 0) {
+        printf("%sError: Arbol no cargado.\n%s", ROJO, RESET);
+        return;
+    }
+    if (indice->gen_size > COMPACTO_MAX_GEN) {
+        printf("%sError: El trie compacto admite genes de largo hasta %d.\n%s", ROJO, COMPACTO_MAX_GEN, RESET);
+        return;
+    }
+
+    TrieCompacto* tc = compactar_trie(indice->raiz, indice->gen_size);
+    if (tc == NULL) {
+        printf("%sError al compactar el arbol.\n%s", ROJO, RESET);
+        return;
+    }
+
+    liberar_arbol(indice->raiz);
+    indice->raiz = NULL;
+    indice->compacto = tc;
+    informar_compacto(tc);
+}
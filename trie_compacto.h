@@ -0,0 +1,142 @@
+#ifndef TRIE_COMPACTO_H
+#define TRIE_COMPACTO_H
+
+#include "trie.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Largo maximo de gen que admite la representacion compacta.
+ *
+ * Cada gen se codifica en 2 bits por base dentro de un entero de 64 bits.
+ * Con "start m compact" se alcanza sin crear el arbol de punteros.
+ */
+#define COMPACTO_MAX_GEN 32
+
+/**
+ * @brief Trie 4-ario de solo lectura en representacion LOUDS.
+ *
+ * Los nodos se numeran por niveles (la raiz es el nodo 0) y solo se guardan
+ * los caminos que llevan a genes con frecuencia mayor a 0. Cada nodo interno
+ * ocupa 4 bits en el bitmap, uno por cada base posible; el hijo que
+ * corresponde al bit b es el nodo rank1(b) + 1. Las hojas quedan al final de
+ * la numeracion y en orden lexicografico.
+ */
+typedef struct TrieCompacto {
+    uint64_t* bits;           /**< Bitmap LOUDS: 4 bits por nodo interno */
+    uint32_t* rank_palabras;  /**< Cantidad de unos antes de cada palabra de 64 bits */
+    long num_palabras;        /**< Largo de bits y rank_palabras */
+    long num_internos;        /**< Nodos de los niveles 0 a profundidad-1 */
+    long num_hojas;           /**< Genes con frecuencia mayor a 0 */
+    ListaInt** hojas;         /**< Listas de posiciones de cada hoja, en orden */
+    int profundidad;          /**< Largo de los genes (m) */
+} TrieCompacto;
+
+/**
+ * @brief Construye la representacion compacta a partir del trie cargado.
+ *
+ * Si tiene exito, las listas de posiciones pasan a pertenecer al trie
+ * compacto y se quitan de los nodos originales, por lo que el arbol de
+ * punteros puede liberarse con liberar_arbol(). Si falla, el arbol no cambia.
+ *
+ * @param raiz Raiz del trie de punteros.
+ * @param m Largo de los genes.
+ * @return Trie compacto o NULL si falla la asignacion de memoria.
+ */
+TrieCompacto* compactar_trie(Nodo* raiz, int m);
+
+/**
+ * @brief Construye la representacion compacta directamente desde la secuencia.
+ *
+ * Ordena los codigos de 2 bits de cada ventana valida y agrupa sus
+ * posiciones, sin crear el arbol de punteros.
+ *
+ * @param secuencia Secuencia validada y empaquetada.
+ * @param m Largo de los genes, entre 1 y COMPACTO_MAX_GEN.
+ * @return Trie compacto o NULL si falla la asignacion de memoria.
+ */
+TrieCompacto* compactar_secuencia(const struct SecuenciaEmpaquetada* secuencia, int m);
+
+/**
+ * @brief Busca un gen valido en el trie compacto.
+ * @param tc Trie compacto.
+ * @param gen Secuencia de largo tc->profundidad con bases A, C, G, T.
+ * @return Lista de posiciones del gen o NULL si no aparece.
+ */
+ListaInt* compacto_buscar(const TrieCompacto* tc, const char* gen);
+
+/**
+ * @brief Indica si un bit del bitmap esta en 1.
+ * @param tc Trie compacto.
+ * @param bit Posicion dentro del bitmap (4 * nodo + base).
+ * @return 1 si el hijo existe, 0 si no.
+ */
+int compacto_bit(const TrieCompacto* tc, long bit);
+
+/**
+ * @brief Cuenta los unos del bitmap antes de una posicion.
+ * @param tc Trie compacto.
+ * @param bit Posicion dentro del bitmap.
+ * @return Cantidad de bits en 1 en el rango [0, bit); el hijo es ese valor + 1.
+ */
+long compacto_rank(const TrieCompacto* tc, long bit);
+
+/**
+ * @brief Recorre un subarbol para obtener la frecuencia maxima o minima.
+ * @param tc Trie compacto.
+ * @param nodo Nodo raiz del subarbol.
+ * @param nivel Nivel del nodo.
+ * @param mode 1 = max, 0 = min.
+ * @param extremum Valor a actualizar.
+ */
+void compacto_recorrido_extremos(const TrieCompacto* tc, long nodo, int nivel, int mode, int* extremum);
+
+/**
+ * @brief Escribe en orden lexicografico los genes de un subarbol.
+ * @param tc Trie compacto.
+ * @param nodo Nodo actual.
+ * @param buffer Cadena para construir el gen.
+ * @param nivel Nivel actual.
+ * @param target_freq Frecuencia a imprimir, o 0 para imprimir todos.
+ * @param salida Buffer donde se escriben los genes.
+ */
+void compacto_imprimir_recorrido(const TrieCompacto* tc, long nodo, char* buffer, int nivel, int target_freq, Salida* salida);
+
+/**
+ * @brief Calcula los bytes ocupados por el trie compacto.
+ * @param tc Trie compacto.
+ * @return Bytes del bitmap, el directorio de rank y el arreglo de hojas.
+ */
+size_t compacto_memoria(const TrieCompacto* tc);
+
+/**
+ * @brief Libera el trie compacto junto con sus listas de posiciones.
+ * @param tc Trie compacto a liberar.
+ */
+void liberar_compacto(TrieCompacto* tc);
+
+/**
+ * @brief Muestra la cantidad de nodos y la memoria del trie compacto.
+ * @param tc Trie compacto.
+ */
+void informar_compacto(const TrieCompacto* tc);
+
+/**
+ * @brief Inicializa un indice que bio_read() construye ya compactado.
+ * @param indice Indice a inicializar; se libera su contenido previo.
+ * @param m Largo del gen, entre 1 y COMPACTO_MAX_GEN.
+ * @return 0 si se inicializo, -1 si m no es valido.
+ */
+int bio_start_compacto(Indice* indice, int m);
+
+/**
+ * @brief Reemplaza el trie cargado por su representacion compacta.
+ *
+ * Necesita el trie de punteros completo; para m grandes conviene
+ * bio_start_compacto().
+ *
+ * @param indice Indice cargado.
+ */
+void bio_compact(Indice* indice);
+
+#endif